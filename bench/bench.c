@@ -0,0 +1,44 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+static volatile unsigned char bench_sink_byte;
+static int bench_failed;
+
+void bench_report(const char* bench, const char* impl, double value, const char* unit) {
+    printf("{\"bench\":\"%s\",\"impl\":\"%s\",\"value\":%.6g,\"unit\":\"%s\"}\n", bench, impl, value, unit);
+    fflush(stdout);
+}
+
+void bench_check(const char* bench, const char* impl, double mismatches) {
+    bench_report(bench, impl, mismatches, "count");
+    if (mismatches != 0) {
+        fprintf(stderr, "FAIL: %s (%s): %g mismatches\n", bench, impl, mismatches);
+        bench_failed = 1;
+    }
+}
+
+void bench_sink(const void* p, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)p;
+    unsigned char acc = 0;
+    for (size_t i = 0; i < size; i++) acc ^= bytes[i];
+    bench_sink_byte = acc;
+}
+
+int main(int argc, char* argv[]) {
+    // Optional filter: only run suites whose name starts with argv[1]
+    const char* filter = argc > 1 ? argv[1] : "";
+
+    // Checks only, without the timed runs
+    if (strcmp(filter, "verify") == 0) {
+        bench_xform_verify();
+        return bench_failed;
+    }
+
+    if (strncmp("objpar", filter, strlen(filter)) == 0) bench_objpar();
+    if (strncmp("osc", filter, strlen(filter)) == 0) bench_osc();
+    if (strncmp("xform", filter, strlen(filter)) == 0) bench_xform();
+    if (strncmp("render", filter, strlen(filter)) == 0) bench_render();
+    return bench_failed;
+}
@@ -0,0 +1,42 @@
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+// Microbenchmark helpers.
+//
+// Every result is printed as one JSON object per line so runs can be diffed
+// or collected by a script:
+//   {"bench":"objpar.parse","impl":"fast","value":123.4,"unit":"MB/s"}
+//
+// Correctness checks report their mismatch count the same way and make the
+// run exit non-zero if it is not 0. `./bench verify` runs only the checks and
+// is what ctest runs.
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "."
+#endif
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void bench_report(const char* bench, const char* impl, double value, const char* unit);
+
+// Reports a mismatch count, failing the run unless it is 0
+void bench_check(const char* bench, const char* impl, double mismatches);
+
+// Keeps the compiler from discarding a computed value
+void bench_sink(const void* p, size_t size);
+
+void bench_objpar(void);
+void bench_osc(void);
+void bench_render(void);
+void bench_xform(void);
+void bench_xform_verify(void);
+
+#endif /* _BENCH_H_ */
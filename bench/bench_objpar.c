@@ -0,0 +1,209 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "file_map.h"
+#include "mesh.h"
+#include "objpar_mt.h"
+#include "bench.h"
+#include "bench_objpar.h"
+
+#define BENCH_MIN_NS 500000000ull // run each case for at least half a second
+#define BENCH_TOKENS 1000000
+
+typedef size_t (*objpar_fn)(const char*, size_t, void*, struct objpar_data*);
+
+static size_t bench_objpar_fast(const char* p_string, size_t string_size, void* p_buffer, struct objpar_data* p_data) {
+    if (!p_buffer) return objpar_get_size(p_string, string_size);
+    return objpar(p_string, string_size, p_buffer, p_data);
+}
+
+// The size query is the count pass, the fill call reuses its counts
+static size_t bench_objpar_mt(const char* p_string, size_t string_size, void* p_buffer, struct objpar_data* p_data) {
+    static objpar_mt_context ctx;
+    if (!p_buffer) return objpar_mt_begin(&ctx, p_string, string_size, 0);
+    return objpar_mt_fill(&ctx, p_buffer, p_data);
+}
+
+// Generates a UV sphere OBJ with roughly `target_faces` quads
+char* bench_make_sphere_obj(int target_faces, size_t* out_size) {
+    int rings = 16;
+    while (rings * rings * 2 < target_faces) rings++;
+    int segments = rings * 2;
+
+    size_t cap = (size_t)(rings + 1) * (size_t)segments * 48 + (size_t)rings * (size_t)segments * 48 + 64;
+    char* text = malloc(cap);
+    if (!text) return NULL;
+    size_t len = 0;
+
+    for (int r = 0; r <= rings; r++) {
+        double phi = 3.14159265358979 * r / rings;
+        for (int s = 0; s < segments; s++) {
+            double theta = 2.0 * 3.14159265358979 * s / segments;
+            len += (size_t)snprintf(text + len, cap - len, "v %.6f %.6f %.6f\n",
+                                    sin(phi) * cos(theta), cos(phi), sin(phi) * sin(theta));
+        }
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            int a = r * segments + s + 1;
+            int b = r * segments + (s + 1) % segments + 1;
+            len += (size_t)snprintf(text + len, cap - len, "f %d %d %d %d\n",
+                                    a, b, b + segments, a + segments);
+        }
+    }
+    *out_size = len;
+    return text;
+}
+
+static void bench_parse(const char* name, const char* impl, objpar_fn fn, const char* text, size_t size) {
+    size_t buffer_size = fn(text, size, NULL, NULL);
+    void* buffer = malloc(buffer_size);
+    if (!buffer) return;
+
+    struct objpar_data data;
+    uint64_t start = bench_now_ns();
+    uint64_t elapsed = 0;
+    size_t bytes = 0;
+    do {
+        fn(text, size, NULL, NULL);
+        fn(text, size, buffer, &data);
+        bytes += size;
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    bench_sink(buffer, buffer_size);
+
+    bench_report(name, impl, (double)bytes / 1e6 / ((double)elapsed / 1e9), "MB/s");
+    free(buffer);
+}
+
+// Fills `tokens` with a mix of OBJ style numbers, exponents and long mantissas
+static void bench_make_tokens(char (*tokens)[32], int count) {
+    srand(1234);
+    for (int i = 0; i < count; i++) {
+        double v = ((double)rand() / RAND_MAX - 0.5) * 20.0;
+        switch (i % 8) {
+            case 0: snprintf(tokens[i], 32, "%.17g", v); break;
+            case 1: snprintf(tokens[i], 32, "%e", v * 1e-9); break;
+            case 2: snprintf(tokens[i], 32, "%.9g", v * 1e30); break;
+            case 3: snprintf(tokens[i], 32, "%d", rand() - RAND_MAX / 2); break;
+            default: snprintf(tokens[i], 32, "%.6f", v); break;
+        }
+    }
+}
+
+static void bench_atof(void) {
+    char (*tokens)[32] = malloc(sizeof(*tokens) * BENCH_TOKENS);
+    float* out = malloc(sizeof(float) * BENCH_TOKENS);
+    if (!tokens || !out) {
+        free(tokens);
+        free(out);
+        return;
+    }
+    bench_make_tokens(tokens, BENCH_TOKENS);
+
+    // Correctness against the correctly rounded libc conversion
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_TOKENS; i++) {
+        float a = objpar_fast_atof(tokens[i]);
+        float b = strtof(tokens[i], NULL);
+        if (memcmp(&a, &b, sizeof(float)) != 0) mismatches++;
+    }
+    bench_report("objpar.atof.mismatch", "fast", mismatches, "count");
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < BENCH_TOKENS; i++) out[i] = (float)atof(tokens[i]);
+    uint64_t libc_ns = bench_now_ns() - start;
+    bench_sink(out, sizeof(float) * BENCH_TOKENS);
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_TOKENS; i++) out[i] = objpar_fast_atof(tokens[i]);
+    uint64_t fast_ns = bench_now_ns() - start;
+    bench_sink(out, sizeof(float) * BENCH_TOKENS);
+
+    bench_report("objpar.atof", "libc", BENCH_TOKENS / ((double)libc_ns / 1e9) / 1e6, "Mnum/s");
+    bench_report("objpar.atof", "fast", BENCH_TOKENS / ((double)fast_ns / 1e9) / 1e6, "Mnum/s");
+
+    free(tokens);
+    free(out);
+}
+
+// A single vertex shared by `count` triangles, the worst case for edge
+// deduplication, or a grid with the same triangle count
+static char* bench_make_valence_obj(int count, bool fan, size_t* out_size) {
+    size_t cap = (size_t)count * 96 + 256;
+    char* text = malloc(cap);
+    if (!text) return NULL;
+    size_t len = 0;
+
+    if (fan) {
+        len += (size_t)snprintf(text + len, cap - len, "v 0 0 0\n");
+        for (int i = 0; i <= count; i++) {
+            double a = 6.28318530717959 * i / (count + 1);
+            len += (size_t)snprintf(text + len, cap - len, "v %.6f %.6f 0\n", cos(a), sin(a));
+        }
+        for (int i = 0; i < count; i++) len += (size_t)snprintf(text + len, cap - len, "f 1 %d %d\n", i + 2, i + 3);
+    } else {
+        int side = (int)sqrt(count / 2.0) + 1;
+        for (int y = 0; y <= side; y++) {
+            for (int x = 0; x <= side; x++) len += (size_t)snprintf(text + len, cap - len, "v %d %d 0\n", x, y);
+        }
+        for (int i = 0; i < count; i++) {
+            int cell = i / 2, x = cell % side, y = cell / side;
+            int a = y * (side + 1) + x + 1;
+            if (i & 1) len += (size_t)snprintf(text + len, cap - len, "f %d %d %d\n", a + 1, a + side + 2, a + side + 1);
+            else len += (size_t)snprintf(text + len, cap - len, "f %d %d %d\n", a, a + 1, a + side + 1);
+        }
+    }
+    *out_size = len;
+    return text;
+}
+
+// Cold mesh_load (parse, edges, cache write) of a fan against a grid
+static void bench_mesh_load(const char* name, bool fan, int count) {
+    size_t size = 0;
+    char* text = bench_make_valence_obj(count, fan, &size);
+    if (!text) return;
+
+    char path[] = "/tmp/bench_mesh_XXXXXX";
+    int fd = mkstemp(path);
+    bool written = fd >= 0 && write(fd, text, size) == (ssize_t)size;
+    if (fd >= 0) close(fd);
+    free(text);
+
+    char cache_path[64];
+    snprintf(cache_path, sizeof(cache_path), "%s" MESH_CACHE_SUFFIX, path);
+    mesh m;
+    uint64_t start = bench_now_ns();
+    if (written && mesh_load(&m, path)) {
+        bench_report(name, fan ? "fan" : "grid", (double)(bench_now_ns() - start) / 1e6, "ms");
+        mesh_free(&m);
+    }
+    remove(cache_path);
+    if (fd >= 0) remove(path);
+}
+
+void bench_objpar(void) {
+    file_map obj;
+    if (file_map_open(&obj, BENCH_DATA_DIR "/strchy.obj")) {
+        bench_parse("objpar.parse.strchy", "libc", bench_objpar_libc, obj.p_data, obj.size);
+        bench_parse("objpar.parse.strchy", "fast", bench_objpar_fast, obj.p_data, obj.size);
+        file_map_close(&obj);
+    }
+
+    size_t size = 0;
+    char* sphere = bench_make_sphere_obj(500000, &size);
+    if (sphere) {
+        bench_parse("objpar.parse.sphere500k", "libc", bench_objpar_libc, sphere, size);
+        bench_parse("objpar.parse.sphere500k", "fast", bench_objpar_fast, sphere, size);
+        bench_parse("objpar.parse.sphere500k", "mt", bench_objpar_mt, sphere, size);
+        free(sphere);
+    }
+
+    bench_atof();
+
+    bench_mesh_load("mesh.load.160k", true, 160000);
+    bench_mesh_load("mesh.load.160k", false, 160000);
+}
@@ -0,0 +1,16 @@
+#ifndef _BENCH_OBJPAR_H_
+#define _BENCH_OBJPAR_H_
+
+#include <stddef.h>
+
+struct objpar_data;
+
+// objpar compiled with the libc conversions (objpar_libc.c). Returns the
+// buffer size when p_buffer is NULL.
+size_t bench_objpar_libc(const char* p_string, size_t string_size, void* p_buffer, struct objpar_data* p_data);
+
+// Generates a UV sphere OBJ text with roughly `target_faces` quads. The
+// caller frees the result.
+char* bench_make_sphere_obj(int target_faces, size_t* out_size);
+
+#endif /* _BENCH_OBJPAR_H_ */
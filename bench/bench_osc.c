@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "envelope.h"
+#include "osc_decode.h"
+#include "bench.h"
+
+#define BENCH_MIN_NS 500000000ull
+#define BENCH_PACKETS 256
+#define BENCH_ROLL_HITS 32 // envelopes started per frame in the drum roll
+
+typedef struct bench_packet {
+    char data[512];
+    int len;
+    const char* sound;
+    int n;
+    float cycle;
+    float gain;
+    int orbit;
+} bench_packet;
+
+static const char* bench_sounds[] = { "bd", "sn", "hh", "superpiano", "arpy", "cp", "808bd", "feel" };
+
+// Builds /dirt/play messages laid out like the ones Tidal sends SuperDirt:
+// string keys, float n/cycle/gain, int orbit and a few keys the decoder skips
+static void bench_make_packets(bench_packet* packets, int count) {
+    srand(777);
+    for (int i = 0; i < count; i++) {
+        bench_packet* p = &packets[i];
+        p->sound = bench_sounds[rand() % (int)(sizeof(bench_sounds) / sizeof(bench_sounds[0]))];
+        p->n = rand() % 12;
+        p->cycle = (float)(i / 4) + (float)(i % 4) * 0.25f;
+        p->gain = 0.5f + (float)(rand() % 100) / 100.0f;
+        p->orbit = rand() % 8;
+
+        if (i % 2) {
+            p->len = (int)tosc_writeMessage(p->data, sizeof(p->data), "/dirt/play", "sfsfsfsfsfsisssf",
+                                            "cps", 0.5625f, "cycle", p->cycle, "delta", 0.4444f,
+                                            "gain", p->gain, "n", (float)p->n, "orbit", p->orbit,
+                                            "s", p->sound, "room", 0.3f);
+        } else {
+            p->len = (int)tosc_writeMessage(p->data, sizeof(p->data), "/dirt/play", "sssfsfsfsisssfsf",
+                                            "_id_", "1", "cycle", p->cycle, "gain", p->gain,
+                                            "n", (float)p->n, "orbit", p->orbit, "s", p->sound,
+                                            "speed", 1.0f, "cps", 0.5625f);
+        }
+    }
+}
+
+static bool bench_osc_matches(const bench_packet* p, const osc_event* ev) {
+    return strcmp(ev->address, "/dirt/play") == 0 && strcmp(ev->sound, p->sound) == 0 &&
+           ev->n == p->n && ev->cycle == p->cycle && ev->gain == p->gain && ev->orbit == p->orbit;
+}
+
+// A drum roll on virtual 60 fps time: BENCH_ROLL_HITS flashes start every
+// frame and each frame evaluates and expires the whole pool once
+static void bench_envelopes(void) {
+    envelope_pool* pool = malloc(sizeof(envelope_pool));
+    if (!pool) return;
+    envelope_pool_init(pool);
+
+    const envelope_shape shape = { 0.005f, 0.30f };
+    const uint64_t frame_ns = 16666667;
+    uint64_t now = 0;
+    uint64_t frames = 0, evaluated = 0, busy_ns = 0;
+    float sum = 0.0f;
+
+    while (busy_ns < BENCH_MIN_NS) {
+        uint64_t t0 = bench_now_ns();
+        for (int h = 0; h < BENCH_ROLL_HITS; h++) {
+            envelope_start(pool, ENVELOPE_FLASH, (int)(frames % ENVELOPE_MAX_OWNERS), &shape, 1.0f, now);
+        }
+        evaluated += pool->active_count;
+        envelope_update(pool, now);
+        busy_ns += bench_now_ns() - t0;
+        sum += pool->total[ENVELOPE_FLASH];
+        now += frame_ns;
+        frames++;
+    }
+    bench_sink(&sum, sizeof(sum));
+
+    bench_report("osc.envelope.active", "pool", (double)evaluated / (double)frames, "envelopes");
+    bench_report("osc.envelope.frame", "pool", (double)busy_ns / 1e3 / (double)frames, "us/frame");
+    bench_report("osc.envelope.dropped", "pool", (double)pool->dropped, "count");
+    free(pool);
+}
+
+void bench_osc(void) {
+    bench_packet* packets = malloc(sizeof(bench_packet) * BENCH_PACKETS);
+    if (!packets) return;
+    bench_make_packets(packets, BENCH_PACKETS);
+
+    size_t bytes_per_pass = 0;
+    for (int i = 0; i < BENCH_PACKETS; i++) bytes_per_pass += (size_t)packets[i].len;
+
+    // Decoded fields must match what went into the packets
+    int mismatches = 0;
+    for (int i = 0; i < BENCH_PACKETS; i++) {
+        tosc_message msg;
+        osc_event ev;
+        if (tosc_parseMessage(&msg, packets[i].data, packets[i].len) != 0 || !osc_decode_message(&msg, &ev) ||
+            !bench_osc_matches(&packets[i], &ev)) {
+            mismatches++;
+        }
+    }
+    bench_report("osc.decode.mismatch", "tinyosc+decode", mismatches, "count");
+
+    // Parse + decode, the receiver thread's per-message work
+    osc_event events[BENCH_PACKETS];
+    uint64_t start = bench_now_ns();
+    uint64_t elapsed = 0;
+    uint64_t messages = 0;
+    do {
+        for (int i = 0; i < BENCH_PACKETS; i++) {
+            tosc_message msg;
+            tosc_parseMessage(&msg, packets[i].data, packets[i].len);
+            osc_decode_message(&msg, &events[i]);
+        }
+        messages += BENCH_PACKETS;
+        elapsed = bench_now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    bench_sink(events, sizeof(events));
+
+    double seconds = (double)elapsed / 1e9;
+    bench_report("osc.decode", "tinyosc+decode", (double)messages / 1e6 / seconds, "Mmsg/s");
+    bench_report("osc.decode.bytes", "tinyosc+decode",
+                 (double)messages / BENCH_PACKETS * (double)bytes_per_pass / 1e6 / seconds, "MB/s");
+
+    free(packets);
+    bench_envelopes();
+}
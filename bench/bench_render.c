@@ -0,0 +1,314 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "framebuffer.h"
+#include "mesh.h"
+#include "mesh_lod.h"
+#include "present.h"
+#include "raster.h"
+#include "transform.h"
+#include "bench.h"
+
+#define BENCH_MIN_NS 500000000ull
+#define BENCH_LINES 4096
+#define BENCH_PRESENT_FRAMES 300
+#define BENCH_SPIN 0.02f // radians per frame, the 60 fps spin rate
+#define BENCH_SPHERE_RINGS 300 // dense LOD test mesh: rings x 2 rings quads
+
+typedef enum bench_mode {
+    BENCH_MODE_WIRE,
+    BENCH_MODE_HIDDEN,
+    BENCH_MODE_FILLED,
+    BENCH_MODE_COUNT
+} bench_mode;
+
+static const char* bench_mode_names[BENCH_MODE_COUNT] = { "wire", "hidden", "filled" };
+
+typedef struct bench_scene {
+    const mesh* m;
+    framebuffer fb;
+    raster_state rs;
+    xform_cache cache;
+    xform_view view;
+} bench_scene;
+
+static bool bench_scene_init(bench_scene* s, const mesh* m, int width, int height) {
+    memset(s, 0, sizeof(*s));
+    s->m = m;
+    xform_view_fit(&s->view, width, height);
+    if (!fb_init(&s->fb, width, height) || !raster_init(&s->rs, width, height, m->tri_count) ||
+        !xform_cache_init(&s->cache, m->vertex_count, m->tri_count)) {
+        xform_cache_free(&s->cache);
+        raster_free(&s->rs);
+        fb_free(&s->fb);
+        return false;
+    }
+    return true;
+}
+
+static void bench_scene_free(bench_scene* s) {
+    xform_cache_free(&s->cache);
+    raster_free(&s->rs);
+    fb_free(&s->fb);
+}
+
+static void bench_transform(bench_scene* s, float angle, xform_mat3* rot) {
+    xform_rotation(rot, angle, angle * 0.7f);
+    xform_project(&s->cache, s->m, rot, &s->view);
+    xform_facing(&s->cache, s->m, rot, &s->view);
+}
+
+// The main loop's raster stage for `mode`, single threaded
+static void bench_raster(bench_scene* s, const xform_mat3* rot, bench_mode mode) {
+    const mesh* m = s->m;
+    const xform_cache* c = &s->cache;
+
+    if (mode == BENCH_MODE_FILLED) {
+        if (!raster_prepare(&s->rs, m, c, rot)) return;
+        for (int tile = 0; tile < s->rs.tiles_x * s->rs.tiles_y; tile++) {
+            raster_tile(&s->rs, &s->fb, m, c, tile, FB_COLOR_RED);
+        }
+        return;
+    }
+    for (uint32_t e = 0; e < m->edge_count; e++) {
+        if (mode == BENCH_MODE_HIDDEN && !xform_edge_front(c, m, e)) continue;
+        uint32_t v0 = m->edges[e * 2];
+        uint32_t v1 = m->edges[e * 2 + 1];
+        fb_draw_line(&s->fb, c->sx[v0], c->sy[v0], c->depth[v0], c->sx[v1], c->sy[v1], c->depth[v1],
+                     GLYPH_BLOCK, FB_COLOR_RED);
+    }
+}
+
+static void bench_draw_line(void) {
+    framebuffer fb;
+    int* coords = malloc(sizeof(int) * 4 * BENCH_LINES * 2);
+    if (!coords || !fb_init(&fb, 300, 90)) {
+        free(coords);
+        return;
+    }
+
+    // First half on the grid, second half reaching far past it
+    srand(99);
+    uint64_t pixels_per_pass = 0;
+    for (int i = 0; i < BENCH_LINES; i++) {
+        int* c = coords + i * 4;
+        c[0] = rand() % fb.width;
+        c[1] = rand() % fb.height;
+        c[2] = rand() % fb.width;
+        c[3] = rand() % fb.height;
+        int dx = abs(c[2] - c[0]), dy = abs(c[3] - c[1]);
+        pixels_per_pass += (uint64_t)(dx > dy ? dx : dy) + 1;
+    }
+    for (int i = BENCH_LINES; i < 2 * BENCH_LINES; i++) {
+        int* c = coords + i * 4;
+        c[0] = rand() % (fb.width * 3) - fb.width;
+        c[1] = rand() % (fb.height * 3) - fb.height;
+        c[2] = rand() % (fb.width * 3) - fb.width;
+        c[3] = rand() % (fb.height * 3) - fb.height;
+    }
+
+    for (int clipped = 0; clipped < 2; clipped++) {
+        const int* lines = coords + clipped * BENCH_LINES * 4;
+        uint64_t start = bench_now_ns();
+        uint64_t elapsed = 0;
+        uint64_t passes = 0;
+        do {
+            fb_clear(&fb);
+            for (int i = 0; i < BENCH_LINES; i++) {
+                const int* c = lines + i * 4;
+                fb_draw_line(&fb, c[0], c[1], 1.0f, c[2], c[3], 2.0f, GLYPH_BLOCK, FB_COLOR_RED);
+            }
+            passes++;
+            elapsed = bench_now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+        bench_sink(fb.glyph, (size_t)fb.width * fb.height);
+
+        double seconds = (double)elapsed / 1e9;
+        if (clipped) {
+            bench_report("render.draw_line.clipped", "scalar", (double)passes * BENCH_LINES / 1e6 / seconds, "Mline/s");
+        } else {
+            bench_report("render.draw_line", "scalar", (double)passes * (double)pixels_per_pass / 1e6 / seconds, "Mpixel/s");
+        }
+    }
+
+    fb_free(&fb);
+    free(coords);
+}
+
+// Transform and raster time per frame for each mode at one terminal size
+static void bench_frame(const mesh* m, int width, int height) {
+    bench_scene s;
+    if (!bench_scene_init(&s, m, width, height)) return;
+
+    char name[64];
+    snprintf(name, sizeof(name), "render.frame.%dx%d", width, height);
+
+    for (int mode = 0; mode < BENCH_MODE_COUNT; mode++) {
+        uint64_t transform_ns = 0, raster_ns = 0;
+        uint64_t frames = 0;
+        float angle = 0.0f;
+        while (transform_ns + raster_ns < BENCH_MIN_NS) {
+            xform_mat3 rot;
+            fb_clear(&s.fb);
+            uint64_t t0 = bench_now_ns();
+            bench_transform(&s, angle, &rot);
+            uint64_t t1 = bench_now_ns();
+            bench_raster(&s, &rot, (bench_mode)mode);
+            uint64_t t2 = bench_now_ns();
+            transform_ns += t1 - t0;
+            raster_ns += t2 - t1;
+            angle += BENCH_SPIN;
+            frames++;
+        }
+        bench_sink(s.fb.glyph, (size_t)width * height);
+
+        char impl[32];
+        snprintf(impl, sizeof(impl), "%s.transform", bench_mode_names[mode]);
+        bench_report(name, impl, (double)transform_ns / 1e6 / (double)frames, "ms/frame");
+        snprintf(impl, sizeof(impl), "%s.raster", bench_mode_names[mode]);
+        bench_report(name, impl, (double)raster_ns / 1e6 / (double)frames, "ms/frame");
+    }
+
+    bench_scene_free(&s);
+}
+
+// Bytes the presenter emits per frame while the model spins
+static void bench_present(const mesh* m, int width, int height) {
+    bench_scene s;
+    present_state p;
+    if (!bench_scene_init(&s, m, width, height)) return;
+    if (!present_init(&p, width, height)) {
+        bench_scene_free(&s);
+        return;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "present.bytes.%dx%d", width, height);
+    const char* footer = "\033[31m▌\033[0m \033[37mOSC MESSAGES: 0  Q:0/0  SCHED:0  DROP:0  LAT:0.0ms\033[0m";
+
+    for (int mode = 0; mode < BENCH_MODE_COUNT; mode++) {
+        size_t full = 0;
+        uint64_t total = 0;
+        float angle = 0.0f;
+
+        present_invalidate(&p);
+        for (int f = 0; f <= BENCH_PRESENT_FRAMES; f++) {
+            xform_mat3 rot;
+            fb_clear(&s.fb);
+            bench_transform(&s, angle, &rot);
+            bench_raster(&s, &rot, (bench_mode)mode);
+            size_t bytes = present_compose(&p, &s.fb, footer);
+            // The first frame is a full repaint, keep it apart
+            if (f == 0) full = bytes;
+            else total += bytes;
+            angle += BENCH_SPIN;
+        }
+
+        char impl[32];
+        snprintf(impl, sizeof(impl), "%s.full", bench_mode_names[mode]);
+        bench_report(name, impl, (double)full, "bytes");
+        snprintf(impl, sizeof(impl), "%s.diff", bench_mode_names[mode]);
+        bench_report(name, impl, (double)total / BENCH_PRESENT_FRAMES, "bytes/frame");
+    }
+
+    present_free(&p);
+    bench_scene_free(&s);
+}
+
+// Writes a UV sphere of quads as an OBJ file
+static bool bench_write_sphere(const char* path, int rings) {
+    FILE* f = fopen(path, "w");
+    if (!f) return false;
+    int segments = rings * 2;
+    for (int r = 0; r <= rings; r++) {
+        double phi = M_PI * r / rings;
+        for (int g = 0; g < segments; g++) {
+            double theta = 2.0 * M_PI * g / segments;
+            fprintf(f, "v %.6f %.6f %.6f\n", 1.5 * sin(phi) * cos(theta), 1.5 * cos(phi), 1.5 * sin(phi) * sin(theta));
+        }
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int g = 0; g < segments; g++) {
+            int a = r * segments + g + 1;
+            int b = r * segments + (g + 1) % segments + 1;
+            fprintf(f, "f %d %d %d %d\n", a, b, b + segments, a + segments);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// Wireframe cost of the full mesh against the level picked for the screen
+static void bench_lod_frame(const mesh_lod* lod, int width, int height) {
+    bench_scene s;
+    if (!bench_scene_init(&s, lod->levels[0], width, height)) return;
+
+    char name[64];
+    snprintf(name, sizeof(name), "render.lod.%dx%d", width, height);
+    int level = mesh_lod_select(lod, s.view.scale, s.view.distance);
+    bench_report(name, "level", level, "index");
+    bench_report(name, "level.edges", lod->levels[level]->edge_count, "count");
+
+    for (int pass = 0; pass < 2; pass++) {
+        s.m = lod->levels[pass ? level : 0];
+        uint64_t busy_ns = 0;
+        uint64_t frames = 0;
+        float angle = 0.0f;
+        while (busy_ns < BENCH_MIN_NS) {
+            xform_mat3 rot;
+            fb_clear(&s.fb);
+            uint64_t t0 = bench_now_ns();
+            bench_transform(&s, angle, &rot);
+            bench_raster(&s, &rot, BENCH_MODE_WIRE);
+            busy_ns += bench_now_ns() - t0;
+            angle += BENCH_SPIN;
+            frames++;
+        }
+        bench_sink(s.fb.glyph, (size_t)width * height);
+        bench_report(name, pass ? "lod.wire" : "full.wire", (double)busy_ns / 1e6 / (double)frames, "ms/frame");
+    }
+    bench_scene_free(&s);
+}
+
+static void bench_lod(void) {
+    char path[] = "/tmp/bench_lod_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return;
+    close(fd);
+
+    char cache_path[64];
+    snprintf(cache_path, sizeof(cache_path), "%s" MESH_CACHE_SUFFIX, path);
+    mesh m;
+    if (bench_write_sphere(path, BENCH_SPHERE_RINGS) && mesh_load(&m, path)) {
+        mesh_lod lod;
+        uint64_t t0 = bench_now_ns();
+        mesh_lod_build(&lod, &m);
+        bench_report("render.lod.build", "cluster", (double)(bench_now_ns() - t0) / 1e6, "ms");
+        bench_report("render.lod.levels", "cluster", lod.level_count, "count");
+
+        bench_lod_frame(&lod, 120, 35);
+        bench_lod_frame(&lod, 300, 90);
+        mesh_lod_free(&lod);
+        mesh_free(&m);
+    }
+    remove(cache_path);
+    remove(path);
+}
+
+void bench_render(void) {
+    bench_draw_line();
+
+    mesh m;
+    if (!mesh_load(&m, BENCH_DATA_DIR "/strchy.obj")) return;
+
+    bench_frame(&m, 120, 35);
+    bench_frame(&m, 300, 90);
+    bench_present(&m, 120, 35);
+    bench_present(&m, 300, 90);
+
+    mesh_free(&m);
+
+    bench_lod();
+}
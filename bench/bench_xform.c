@@ -0,0 +1,190 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deform.h"
+#include "transform.h"
+#include "bench.h"
+
+#define BENCH_MIN_NS 500000000ull
+#define BENCH_VERTICES 1000003 // odd on purpose so every kernel runs its scalar tail
+
+// The per-vertex path the renderer used before the combined matrix
+static void bench_legacy_vertex(float x, float y, float z, float angle, int* sx, int* sy, int center_x, int center_y) {
+    float cos_a = cos(angle);
+    float sin_a = sin(angle);
+    float nx = x * cos_a + z * sin_a;
+    float nz = -x * sin_a + z * cos_a;
+    x = nx;
+    z = nz;
+
+    cos_a = cos(angle * 0.7f);
+    sin_a = sin(angle * 0.7f);
+    float ny = y * cos_a - z * sin_a;
+    nz = y * sin_a + z * cos_a;
+    y = ny;
+    z = nz;
+
+    float factor = 20.0f / (z + 4.0f);
+    *sx = (int)(x * factor) + center_x;
+    *sy = (int)(y * factor) + center_y;
+}
+
+static bool bench_xform_equal(const xform_cache* a, const xform_cache* b, uint32_t i) {
+    return a->sx[i] == b->sx[i] && a->sy[i] == b->sy[i] &&
+           memcmp(&a->depth[i], &b->depth[i], sizeof(float)) == 0;
+}
+
+// With `timed` unset only the exactness checks run
+static void bench_project(bool timed) {
+    float* positions = malloc(sizeof(float) * 3 * BENCH_VERTICES);
+    xform_cache reference;
+    xform_cache result;
+    if (!positions || !xform_cache_init(&reference, BENCH_VERTICES, 0) || !xform_cache_init(&result, BENCH_VERTICES, 0)) {
+        free(positions);
+        return;
+    }
+
+    srand(4321);
+    for (int i = 0; i < 3 * BENCH_VERTICES; i++) positions[i] = ((float)rand() / RAND_MAX - 0.5f) * 2.0f;
+
+    mesh m;
+    memset(&m, 0, sizeof(m));
+    m.x = positions;
+    m.y = positions + BENCH_VERTICES;
+    m.z = positions + 2 * BENCH_VERTICES;
+    m.vertex_count = BENCH_VERTICES;
+
+    float angle = 1.2345f;
+    xform_mat3 rot;
+    xform_rotation(&rot, angle, angle * 0.7f);
+    xform_view view = { 20.0f, 4.0f, 60, 17 };
+
+    // Every SIMD kernel must match the scalar kernel bit for bit
+    xform_project_kernel(&reference, &m, &rot, &view, XFORM_KERNEL_SCALAR);
+    for (int k = XFORM_KERNEL_SCALAR + 1; k < XFORM_KERNEL_COUNT; k++) {
+        if (!xform_kernel_supported((xform_kernel)k)) continue;
+        xform_project_kernel(&result, &m, &rot, &view, (xform_kernel)k);
+        int mismatches = 0;
+        for (uint32_t i = 0; i < BENCH_VERTICES; i++) {
+            if (!bench_xform_equal(&reference, &result, i)) mismatches++;
+        }
+        bench_check("xform.mismatch", xform_kernel_name((xform_kernel)k), mismatches);
+    }
+
+    // The combined matrix rounds differently from the old chained rotations,
+    // so positions are not bit-identical; the cell each vertex lands on is what
+    // the renderer uses, and none of these vertices may move to another one
+    int moved = 0;
+    for (uint32_t i = 0; i < BENCH_VERTICES; i++) {
+        int sx, sy;
+        bench_legacy_vertex(m.x[i], m.y[i], m.z[i], angle, &sx, &sy, view.center_x, view.center_y);
+        if (sx != reference.sx[i] || sy != reference.sy[i]) moved++;
+    }
+    bench_check("xform.legacy.cell_mismatch", "scalar", moved);
+
+    // Cache resident and memory bound vertex counts
+    static const struct { const char* name; uint32_t count; } sizes[] = {
+        { "xform.project.32k", 32771 },
+        { "xform.project.1m", BENCH_VERTICES },
+    };
+    for (size_t s = 0; timed && s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        m.vertex_count = sizes[s].count;
+        for (int k = XFORM_KERNEL_SCALAR; k < XFORM_KERNEL_COUNT; k++) {
+            if (!xform_kernel_supported((xform_kernel)k)) continue;
+            uint64_t start = bench_now_ns();
+            uint64_t elapsed = 0;
+            uint64_t vertices = 0;
+            do {
+                xform_project_kernel(&result, &m, &rot, &view, (xform_kernel)k);
+                vertices += m.vertex_count;
+                elapsed = bench_now_ns() - start;
+            } while (elapsed < BENCH_MIN_NS);
+            bench_sink(result.depth, sizeof(float) * m.vertex_count);
+            bench_report(sizes[s].name, xform_kernel_name((xform_kernel)k), (double)vertices / 1e6 / ((double)elapsed / 1e9), "Mvert/s");
+        }
+    }
+
+    xform_cache_free(&reference);
+    xform_cache_free(&result);
+    free(positions);
+}
+
+// Deformation pass with every per-vertex effect active
+static void bench_deform_kernels(deform_state* reference, deform_state* result, mesh* m, bool timed) {
+    float amount[DEFORM_EFFECT_COUNT] = { [DEFORM_NOISE] = 0.2f, [DEFORM_PULSE] = 0.3f, [DEFORM_TWIST] = 1.2f };
+    memcpy(reference->amount, amount, sizeof(amount));
+    memcpy(result->amount, amount, sizeof(amount));
+    reference->noise_phase = result->noise_phase = 0.7f;
+
+    // The AVX2 build must match the baseline one bit for bit
+    const mesh* expect = deform_apply_kernel(reference, m, DEFORM_KERNEL_BASE);
+    for (int k = DEFORM_KERNEL_BASE + 1; k < DEFORM_KERNEL_COUNT; k++) {
+        if (!deform_kernel_supported((deform_kernel)k)) continue;
+        const mesh* got = deform_apply_kernel(result, m, (deform_kernel)k);
+        int mismatches = 0;
+        for (uint32_t i = 0; i < m->vertex_count; i++) {
+            if (memcmp(&expect->x[i], &got->x[i], sizeof(float)) != 0 ||
+                memcmp(&expect->y[i], &got->y[i], sizeof(float)) != 0 ||
+                memcmp(&expect->z[i], &got->z[i], sizeof(float)) != 0) {
+                mismatches++;
+            }
+        }
+        bench_check("xform.deform.mismatch", deform_kernel_name((deform_kernel)k), mismatches);
+    }
+
+    static const struct { const char* name; uint32_t count; } sizes[] = {
+        { "xform.deform.100k", 100003 },
+        { "xform.deform.1m", BENCH_VERTICES },
+    };
+    for (size_t s = 0; timed && s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        m->vertex_count = result->count = sizes[s].count;
+        for (int k = DEFORM_KERNEL_BASE; k < DEFORM_KERNEL_COUNT; k++) {
+            if (!deform_kernel_supported((deform_kernel)k)) continue;
+            uint64_t start = bench_now_ns();
+            uint64_t elapsed = 0;
+            uint64_t vertices = 0;
+            do {
+                deform_apply_kernel(result, m, (deform_kernel)k);
+                vertices += m->vertex_count;
+                elapsed = bench_now_ns() - start;
+            } while (elapsed < BENCH_MIN_NS);
+            bench_sink(result->x, sizeof(float) * m->vertex_count);
+            bench_report(sizes[s].name, deform_kernel_name((deform_kernel)k), (double)vertices / 1e6 / ((double)elapsed / 1e9), "Mvert/s");
+        }
+    }
+}
+
+static void bench_deform(bool timed) {
+    float* positions = malloc(sizeof(float) * 3 * BENCH_VERTICES);
+    if (!positions) return;
+
+    srand(1234);
+    for (int i = 0; i < 3 * BENCH_VERTICES; i++) positions[i] = ((float)rand() / RAND_MAX - 0.5f) * 2.0f;
+
+    mesh m;
+    memset(&m, 0, sizeof(m));
+    m.x = positions;
+    m.y = positions + BENCH_VERTICES;
+    m.z = positions + 2 * BENCH_VERTICES;
+    m.vertex_count = BENCH_VERTICES;
+
+    deform_state reference, result;
+    memset(&reference, 0, sizeof(reference));
+    memset(&result, 0, sizeof(result));
+    if (deform_init(&reference, &m, false) && deform_init(&result, &m, false)) bench_deform_kernels(&reference, &result, &m, timed);
+
+    deform_free(&reference);
+    deform_free(&result);
+    free(positions);
+}
+
+void bench_xform(void) {
+    bench_project(true);
+    bench_deform(true);
+}
+
+void bench_xform_verify(void) {
+    bench_project(false);
+    bench_deform(false);
+}
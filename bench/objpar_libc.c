@@ -0,0 +1,9 @@
+// objpar built with its default libc atof/atoi, the baseline for the fast path
+#include "objpar.h"
+
+#include "bench_objpar.h"
+
+objpar_size_t bench_objpar_libc(const char* p_string, objpar_size_t string_size, void* p_buffer, struct objpar_data* p_data) {
+    if (!p_buffer) return objpar_get_size(p_string, string_size);
+    return objpar(p_string, string_size, p_buffer, p_data);
+}
@@ -0,0 +1,313 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "deform.h"
+#include "file_map.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define DEFORM_X86 1
+#endif
+
+// Largest combined level per effect. Noise and pulse keep every vertex on
+// its own side of the center, twist keeps the polynomials accurate.
+static const float deform_limit[DEFORM_EFFECT_COUNT] = {
+    [DEFORM_NOISE] = 0.3f,  // the blended noise reaches sqrt(2) times this
+    [DEFORM_PULSE] = 0.5f,
+    [DEFORM_TWIST] = 1.5f,  // radians
+    [DEFORM_SPIN] = 10.0f,  // radians per second
+};
+
+#define DEFORM_NOISE_SPEED 0.9f // radians of noise drift per second
+
+static const char* deform_effect_names[DEFORM_EFFECT_COUNT] = { "noise", "pulse", "twist", "spin" };
+static const char* deform_key_names[] = { "gain", "n", "cycle", "orbit", "hit" };
+
+static int deform_lookup(const char* name, const char* const* names, int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) return i;
+    }
+    return -1;
+}
+
+// One line without its comment; false on a syntax error
+static bool deform_parse_line(deform_state* d, char* line) {
+    char* comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+
+    char address[32], key[16], effect[16], extra;
+    float amount, decay;
+    int fields = sscanf(line, "%31s %15s %15s %f %f %c", address, key, effect, &amount, &decay, &extra);
+    if (fields <= 0) return true;
+    if (fields != 5 || decay <= 0.0f || d->mapping_count >= DEFORM_MAX_MAPPINGS) return false;
+
+    int k = deform_lookup(key, deform_key_names, sizeof(deform_key_names) / sizeof(deform_key_names[0]));
+    int e = deform_lookup(effect, deform_effect_names, DEFORM_EFFECT_COUNT);
+    if (k < 0 || e < 0) return false;
+
+    deform_mapping* map = &d->mappings[d->mapping_count++];
+    memcpy(map->address, address, sizeof(map->address));
+    map->key = (deform_key)k;
+    map->effect = (deform_effect)e;
+    map->amount = amount;
+    map->decay = decay;
+    map->level = 0.0f;
+    return true;
+}
+
+bool deform_parse(deform_state* d, const char* text, size_t size) {
+    d->mapping_count = 0;
+
+    size_t pos = 0;
+    for (int number = 1; pos < size; number++) {
+        const char* end = memchr(text + pos, '\n', size - pos);
+        size_t len = end ? (size_t)(end - (text + pos)) : size - pos;
+
+        char line[256];
+        size_t copy = len < sizeof(line) - 1 ? len : sizeof(line) - 1;
+        memcpy(line, text + pos, copy);
+        line[copy] = '\0';
+        if (len >= sizeof(line) || !deform_parse_line(d, line)) {
+            printf("Error: Bad deform mapping on line %d: %.*s\n", number, (int)copy, text + pos);
+            return false;
+        }
+        pos += len + 1;
+    }
+    return true;
+}
+
+bool deform_load(deform_state* d, const char* path) {
+    if (!path) return deform_parse(d, DEFORM_DEFAULT_CONFIG, strlen(DEFORM_DEFAULT_CONFIG));
+
+    file_map fm;
+    if (!file_map_open(&fm, path)) return false;
+    bool ok = deform_parse(d, fm.p_data, fm.size);
+    file_map_close(&fm);
+    return ok;
+}
+
+// Stateless hash of the vertex index, uniform in [-1, 1)
+static float deform_noise(uint32_t i, uint32_t seed) {
+    uint32_t h = i * 0x9E3779B1u ^ seed;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return (float)(h >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+bool deform_init(deform_state* d, const mesh* m, bool planes) {
+    size_t n = m->vertex_count ? m->vertex_count : 1;
+    size_t t = planes ? m->tri_count : 0;
+
+    d->p_buffer = malloc((n * 5 + t * 4) * sizeof(float));
+    if (!d->p_buffer) return false;
+
+    d->noise0 = (float*)d->p_buffer;
+    d->noise1 = d->noise0 + n;
+    d->x = d->noise1 + n;
+    d->y = d->x + n;
+    d->z = d->y + n;
+    d->tri_nx = d->z + n;
+    d->tri_ny = d->tri_nx + t;
+    d->tri_nz = d->tri_ny + t;
+    d->tri_d = d->tri_nz + t;
+    d->count = m->vertex_count;
+    d->tri_count = (uint32_t)t;
+
+    float top = 0.0f;
+    for (uint32_t i = 0; i < m->vertex_count; i++) {
+        d->noise0[i] = deform_noise(i, 0x1234567u);
+        d->noise1[i] = deform_noise(i, 0x89ABCDEu);
+        float a = fabsf(m->y[i]);
+        if (a > top) top = a;
+    }
+    d->twist_scale = top > 0.0f ? 1.0f / top : 0.0f;
+
+    memset(d->amount, 0, sizeof(d->amount));
+    d->noise_phase = 0.0f;
+    return true;
+}
+
+void deform_free(deform_state* d) {
+    free(d->p_buffer);
+    d->p_buffer = NULL;
+    d->noise0 = NULL;
+    d->noise1 = NULL;
+    d->x = NULL;
+    d->y = NULL;
+    d->z = NULL;
+    d->tri_nx = NULL;
+    d->tri_ny = NULL;
+    d->tri_nz = NULL;
+    d->tri_d = NULL;
+    d->count = 0;
+    d->tri_count = 0;
+}
+
+static float deform_key_value(deform_key key, const osc_event* ev) {
+    switch (key) {
+        case DEFORM_KEY_GAIN: return ev->gain;
+        case DEFORM_KEY_N: return (float)ev->n;
+        case DEFORM_KEY_CYCLE: return ev->cycle - floorf(ev->cycle);
+        case DEFORM_KEY_ORBIT: return (float)ev->orbit;
+        default: return 1.0f;
+    }
+}
+
+void deform_trigger(deform_state* d, const osc_event* ev) {
+    for (int i = 0; i < d->mapping_count; i++) {
+        deform_mapping* map = &d->mappings[i];
+        if ((map->address[0] != '*' || map->address[1] != '\0') &&
+            strncmp(map->address, ev->address, sizeof(map->address)) != 0) {
+            continue;
+        }
+        map->level += map->amount * deform_key_value(map->key, ev);
+    }
+}
+
+void deform_update(deform_state* d, float dt) {
+    memset(d->amount, 0, sizeof(d->amount));
+    for (int i = 0; i < d->mapping_count; i++) {
+        deform_mapping* map = &d->mappings[i];
+        map->level *= expf(-dt / map->decay);
+        if (fabsf(map->level) < DEFORM_REST) map->level = 0.0f;
+        d->amount[map->effect] += map->level;
+    }
+    for (int e = 0; e < DEFORM_EFFECT_COUNT; e++) {
+        float limit = deform_limit[e];
+        if (d->amount[e] > limit) d->amount[e] = limit;
+        else if (d->amount[e] < -limit) d->amount[e] = -limit;
+    }
+
+    d->noise_phase += DEFORM_NOISE_SPEED * dt;
+    if (d->noise_phase > 6.2831853f) d->noise_phase -= 6.2831853f;
+}
+
+// Vertices [0, count). Written so the compiler can vectorize it: no calls,
+// no branches, restrict planes. `scale` and the noise weights build the
+// radial factor, `twist` is radians per unit of rest height.
+static inline __attribute__((always_inline)) void deform_span(
+    float* restrict ox, float* restrict oy, float* restrict oz,
+    const float* restrict x, const float* restrict y, const float* restrict z,
+    const float* restrict n0, const float* restrict n1, uint32_t count,
+    float scale, float noise_c, float noise_s, float twist) {
+    for (uint32_t i = 0; i < count; i++) {
+        float k = scale + noise_c * n0[i] + noise_s * n1[i];
+        float px = x[i] * k;
+        float pz = z[i] * k;
+
+        // sin and cos to the t^5 and t^6 terms, within 0.004 for |t| <= 1.5
+        float t = twist * y[i];
+        float t2 = t * t;
+        float c = 1.0f + t2 * (-0.5f + t2 * (1.0f / 24.0f - t2 * (1.0f / 720.0f)));
+        float s = t * (1.0f + t2 * (-1.0f / 6.0f + t2 * (1.0f / 120.0f)));
+
+        ox[i] = px * c - pz * s;
+        oy[i] = y[i] * k;
+        oz[i] = px * s + pz * c;
+    }
+}
+
+static void deform_kernel_base(deform_state* d, const mesh* m, float scale, float noise_c, float noise_s, float twist) {
+    deform_span(d->x, d->y, d->z, m->x, m->y, m->z, d->noise0, d->noise1, m->vertex_count, scale, noise_c, noise_s, twist);
+}
+
+#ifdef DEFORM_X86
+__attribute__((target("avx2")))
+static void deform_kernel_avx2(deform_state* d, const mesh* m, float scale, float noise_c, float noise_s, float twist) {
+    deform_span(d->x, d->y, d->z, m->x, m->y, m->z, d->noise0, d->noise1, m->vertex_count, scale, noise_c, noise_s, twist);
+}
+#endif
+
+// Triangle planes of the deformed positions, like mesh_image_planes() in mesh.c but in
+// single precision: they only steer culling and shading for one frame
+static void deform_planes(deform_state* d, const mesh* m) {
+    const float* restrict x = d->x;
+    const float* restrict y = d->y;
+    const float* restrict z = d->z;
+    float* restrict nx = d->tri_nx;
+    float* restrict ny = d->tri_ny;
+    float* restrict nz = d->tri_nz;
+    float* restrict nd = d->tri_d;
+    for (uint32_t i = 0; i < m->tri_count; i++) {
+        const uint32_t* tri = m->tris + (size_t)i * 3;
+        float ax = x[tri[0]], ay = y[tri[0]], az = z[tri[0]];
+        float ux = x[tri[1]] - ax, uy = y[tri[1]] - ay, uz = z[tri[1]] - az;
+        float vx = x[tri[2]] - ax, vy = y[tri[2]] - ay, vz = z[tri[2]] - az;
+        float cx = uy * vz - uz * vy;
+        float cy = uz * vx - ux * vz;
+        float cz = ux * vy - uy * vx;
+        float len2 = cx * cx + cy * cy + cz * cz;
+        float inv = len2 > 0.0f ? 1.0f / sqrtf(len2) : 0.0f;
+        cx *= inv;
+        cy *= inv;
+        cz *= inv;
+        nx[i] = cx;
+        ny[i] = cy;
+        nz[i] = cz;
+        nd[i] = cx * ax + cy * ay + cz * az;
+    }
+}
+
+bool deform_kernel_supported(deform_kernel kernel) {
+    switch (kernel) {
+        case DEFORM_KERNEL_BASE: return true;
+#ifdef DEFORM_X86
+        case DEFORM_KERNEL_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+const char* deform_kernel_name(deform_kernel kernel) {
+    switch (kernel) {
+        case DEFORM_KERNEL_BASE: return "base";
+        case DEFORM_KERNEL_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+const mesh* deform_apply_kernel(deform_state* d, const mesh* m, deform_kernel kernel) {
+    const float* a = d->amount;
+    if (m->vertex_count > d->count ||
+        (a[DEFORM_NOISE] == 0.0f && a[DEFORM_PULSE] == 0.0f && a[DEFORM_TWIST] == 0.0f)) {
+        return m;
+    }
+
+    float scale = 1.0f + a[DEFORM_PULSE];
+    float noise_c = a[DEFORM_NOISE] * cosf(d->noise_phase);
+    float noise_s = a[DEFORM_NOISE] * sinf(d->noise_phase);
+    float twist = a[DEFORM_TWIST] * d->twist_scale;
+
+    if (!deform_kernel_supported(kernel)) kernel = DEFORM_KERNEL_BASE;
+#ifdef DEFORM_X86
+    if (kernel == DEFORM_KERNEL_AVX2) deform_kernel_avx2(d, m, scale, noise_c, noise_s, twist);
+    else deform_kernel_base(d, m, scale, noise_c, noise_s, twist);
+#else
+    deform_kernel_base(d, m, scale, noise_c, noise_s, twist);
+#endif
+
+    d->shape = *m;
+    d->shape.x = d->x;
+    d->shape.y = d->y;
+    d->shape.z = d->z;
+
+    // Planes of a coarser level fit as well, it never has more triangles
+    if (d->tri_count > 0 && m->tri_count <= d->tri_count) {
+        deform_planes(d, m);
+        d->shape.tri_nx = d->tri_nx;
+        d->shape.tri_ny = d->tri_ny;
+        d->shape.tri_nz = d->tri_nz;
+        d->shape.tri_d = d->tri_d;
+    }
+    return &d->shape;
+}
+
+const mesh* deform_apply(deform_state* d, const mesh* m) {
+    static int best = -1;
+    if (best < 0) best = deform_kernel_supported(DEFORM_KERNEL_AVX2) ? DEFORM_KERNEL_AVX2 : DEFORM_KERNEL_BASE;
+    return deform_apply_kernel(d, m, (deform_kernel)best);
+}
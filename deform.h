@@ -0,0 +1,134 @@
+#ifndef _DEFORM_H_
+#define _DEFORM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mesh.h"
+#include "osc_decode.h"
+
+// OSC-driven mesh deformation.
+//
+// Events bump the level of the effects they are mapped to and every level
+// decays exponentially back to zero. Once per frame the levels are folded
+// into a few scalars and all vertices are displaced in model space, between
+// the rest pose and the rotation/projection:
+//   noise - each vertex moves along its radius by a fixed random amount,
+//           blended between two random planes so the pattern keeps drifting
+//   pulse - the whole mesh scales up
+//   twist - vertices turn about the y axis in proportion to their height
+//   spin  - not per vertex, added to the model rotation speed
+// The vertex pass only reads and writes SoA planes with multiplies and adds
+// (the twist angle stays small enough for short polynomials in place of
+// sin/cos), so the compiler vectorizes it; an AVX2 build of the same loop is
+// picked at runtime. While every level is at rest the mesh is passed through
+// untouched. When set up with planes, the deformed copy also gets its triangle
+// planes recomputed so hidden-line culling and filled shading follow the
+// deformation; wireframe only needs the positions and skips that pass.
+//
+// Which event field drives which effect is read from a text file, one
+// mapping per line, '#' starting a comment:
+//   <address|*> <gain|n|cycle|orbit|hit> <noise|pulse|twist|spin> <amount> <decay>
+// A matching event adds amount * field to the mapping's level (cycle uses its
+// fractional part, hit is always 1); the level falls by a factor e every
+// `decay` seconds. Without a file, DEFORM_DEFAULT_CONFIG is used.
+
+#define DEFORM_MAX_MAPPINGS 32
+#define DEFORM_REST 1e-4f // levels below this count as zero
+
+#define DEFORM_DEFAULT_CONFIG \
+    "/dirt/play gain  pulse 0.15 0.20\n" \
+    "/dirt/play hit   noise 0.08 0.35\n" \
+    "/dirt/play cycle twist 0.60 0.80\n" \
+    "/dirt/play gain  spin  2.00 0.50\n"
+
+typedef enum deform_effect {
+    DEFORM_NOISE,
+    DEFORM_PULSE,
+    DEFORM_TWIST,
+    DEFORM_SPIN,
+    DEFORM_EFFECT_COUNT
+} deform_effect;
+
+typedef enum deform_key {
+    DEFORM_KEY_GAIN,
+    DEFORM_KEY_N,
+    DEFORM_KEY_CYCLE,
+    DEFORM_KEY_ORBIT,
+    DEFORM_KEY_HIT,
+} deform_key;
+
+typedef enum deform_kernel {
+    DEFORM_KERNEL_BASE, // the build's baseline vector width, SSE2 on x86-64
+    DEFORM_KERNEL_AVX2,
+    DEFORM_KERNEL_COUNT
+} deform_kernel;
+
+typedef struct deform_mapping {
+    char address[32]; // "*" matches any address
+    deform_key key;
+    deform_effect effect;
+    float amount;
+    float decay;      // seconds
+    float level;
+} deform_mapping;
+
+typedef struct deform_state {
+    deform_mapping mappings[DEFORM_MAX_MAPPINGS];
+    int mapping_count;
+
+    // Per-frame parameters, from deform_update()
+    float amount[DEFORM_EFFECT_COUNT];
+    float noise_phase;
+
+    // Rest pose noise planes, the deformed positions and, with planes, the
+    // deformed triangle planes, one allocation
+    uint32_t count;
+    uint32_t tri_count; // 0 without planes
+    float* noise0;
+    float* noise1;
+    float* x;
+    float* y;
+    float* z;
+    float* tri_nx;
+    float* tri_ny;
+    float* tri_nz;
+    float* tri_d;
+    void* p_buffer;
+    float twist_scale; // 1 / largest |y|, so the twist is in radians at the ends
+
+    mesh shape; // the model with its positions swapped for the deformed ones
+} deform_state;
+
+// Replaces the mappings with the lines in `text`, which need not be null
+// terminated. Prints the offending line and returns false on a syntax error.
+bool deform_parse(deform_state* d, const char* text, size_t size);
+
+// Reads the mappings from `path`, or the defaults when `path` is NULL
+bool deform_load(deform_state* d, const char* path);
+
+// Sizes the vertex planes for `m` and seeds its noise. Mappings are kept.
+// Any mesh with at most as many vertices can be deformed afterwards, such as
+// a coarser level of detail of `m`. With `planes`, room for the triangle
+// planes of `m` is kept too and they are recomputed on every deformed frame.
+bool deform_init(deform_state* d, const mesh* m, bool planes);
+void deform_free(deform_state* d);
+
+// Feeds one applied event to every mapping that matches its address
+void deform_trigger(deform_state* d, const osc_event* ev);
+
+// Decays all levels by `dt` seconds and works out this frame's parameters
+void deform_update(deform_state* d, float dt);
+
+// The mesh to draw this frame: `m` itself while at rest, otherwise the
+// deformed copy, built with the best kernel this CPU supports
+const mesh* deform_apply(deform_state* d, const mesh* m);
+
+// Same with an explicit kernel; unsupported kernels fall back to the base one
+const mesh* deform_apply_kernel(deform_state* d, const mesh* m, deform_kernel kernel);
+
+bool deform_kernel_supported(deform_kernel kernel);
+const char* deform_kernel_name(deform_kernel kernel);
+
+#endif /* _DEFORM_H_ */
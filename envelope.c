@@ -0,0 +1,73 @@
+#include <string.h>
+
+#include "envelope.h"
+
+void envelope_pool_init(envelope_pool* pool) {
+    // Lowest indices first out of the free list
+    for (uint32_t i = 0; i < ENVELOPE_CAPACITY; i++) pool->free_list[i] = ENVELOPE_CAPACITY - 1 - i;
+    pool->free_count = ENVELOPE_CAPACITY;
+    pool->active_count = 0;
+    memset(pool->total, 0, sizeof(pool->total));
+    memset(pool->owned, 0, sizeof(pool->owned));
+    pool->started = 0;
+    pool->dropped = 0;
+}
+
+bool envelope_start(envelope_pool* pool, envelope_target target, int owner, const envelope_shape* shape,
+                    float peak, uint64_t start_ns) {
+    if (pool->free_count == 0) {
+        pool->dropped++;
+        return false;
+    }
+    uint32_t index = pool->free_list[--pool->free_count];
+    envelope* e = &pool->items[index];
+
+    e->start_ns = start_ns;
+    e->attack = shape->attack > 0.0f ? shape->attack : 0.0f;
+    e->attack_inv = e->attack > 0.0f ? 1.0f / e->attack : 0.0f;
+    e->decay_inv = shape->decay > 0.0f ? 1.0f / shape->decay : 1e9f;
+    e->peak = peak;
+    e->owner = owner >= 0 && owner < ENVELOPE_MAX_OWNERS ? owner : ENVELOPE_NO_OWNER;
+    e->target = (uint8_t)target;
+
+    pool->active[pool->active_count++] = index;
+    pool->started++;
+    return true;
+}
+
+// Value at `t` seconds after the start. False once the envelope is over.
+static inline bool envelope_eval(const envelope* e, float t, float* value) {
+    if (t < e->attack) {
+        *value = t <= 0.0f ? 0.0f : e->peak * t * e->attack_inv;
+        return true;
+    }
+    float u = (t - e->attack) * e->decay_inv;
+    if (u >= 1.0f) return false;
+    float fall = 1.0f - u;
+    *value = e->peak * fall * fall;
+    return true;
+}
+
+void envelope_update(envelope_pool* pool, uint64_t now_ns) {
+    memset(pool->total, 0, sizeof(pool->total));
+    memset(pool->owned, 0, sizeof(pool->owned));
+
+    uint32_t i = 0;
+    while (i < pool->active_count) {
+        uint32_t index = pool->active[i];
+        const envelope* e = &pool->items[index];
+        // Envelopes scheduled ahead of now sit at zero until they start
+        float t = now_ns > e->start_ns ? (float)((double)(now_ns - e->start_ns) * 1e-9) : 0.0f;
+        float value;
+
+        if (!envelope_eval(e, t, &value)) {
+            // Finished: swap in the last active one and look at slot i again
+            pool->active[i] = pool->active[--pool->active_count];
+            pool->free_list[pool->free_count++] = index;
+            continue;
+        }
+        pool->total[e->target] += value;
+        if (e->owner >= 0) pool->owned[e->owner][e->target] += value;
+        i++;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef _ENVELOPE_H_
+#define _ENVELOPE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "osc_channels.h"
+
+// Per-event animation envelopes.
+//
+// A hit starts an attack/decay envelope on a target: the line flash of the
+// channel it belongs to, the model scale, and so on. Envelopes live in a
+// fixed pool handed out through a free list and are iterated through a
+// dense list of the active ones, so starting, evaluating and expiring one
+// never allocates and a frame costs one evaluation per active envelope, no
+// matter how many cells or vertices use the result. Once per frame
+// envelope_update() sums them into a small parameter block that the
+// transform and overlay stages read; finished envelopes go back to the free
+// list in the same pass. When the pool is full new envelopes are dropped.
+//
+// Shape: linear rise to `peak` over `attack` seconds, then a fall with
+// (1 - u)^2 over `decay` seconds, after which the envelope is finished.
+
+#define ENVELOPE_CAPACITY 1024
+#define ENVELOPE_MAX_OWNERS OSC_CHANNEL_MAX // per-channel results
+#define ENVELOPE_NO_OWNER -1
+
+typedef enum envelope_target {
+    ENVELOPE_FLASH,  // text brightness of the owning channel's line
+    ENVELOPE_SCALE,  // relative model scale
+    ENVELOPE_TARGET_COUNT
+} envelope_target;
+
+typedef struct envelope_shape {
+    float attack; // seconds
+    float decay;  // seconds
+} envelope_shape;
+
+typedef struct envelope {
+    uint64_t start_ns;
+    float attack_inv; // 1 / attack, 0 for an instant attack
+    float decay_inv;
+    float attack;
+    float peak;
+    int32_t owner;
+    uint8_t target;
+} envelope;
+
+typedef struct envelope_pool {
+    envelope items[ENVELOPE_CAPACITY];
+    uint32_t free_list[ENVELOPE_CAPACITY];
+    uint32_t free_count;
+    uint32_t active[ENVELOPE_CAPACITY]; // indices into items, unordered
+    uint32_t active_count;
+
+    // Results of the last envelope_update(): every envelope adds to `total`,
+    // owned ones also to their owner's row
+    float total[ENVELOPE_TARGET_COUNT];
+    float owned[ENVELOPE_MAX_OWNERS][ENVELOPE_TARGET_COUNT];
+
+    uint64_t started;
+    uint64_t dropped; // pool was full
+} envelope_pool;
+
+void envelope_pool_init(envelope_pool* pool);
+
+// Starts an envelope at `start_ns` (CLOCK_MONOTONIC). `owner` is a channel
+// index or ENVELOPE_NO_OWNER. Returns false when the pool is full.
+bool envelope_start(envelope_pool* pool, envelope_target target, int owner, const envelope_shape* shape,
+                    float peak, uint64_t start_ns);
+
+// Evaluates every active envelope once at `now_ns`, refills the results and
+// releases the envelopes that have finished
+void envelope_update(envelope_pool* pool, uint64_t now_ns);
+
+static inline float envelope_owned(const envelope_pool* pool, int owner, envelope_target target) {
+    if (owner < 0 || owner >= ENVELOPE_MAX_OWNERS) return 0.0f;
+    return pool->owned[owner][target];
+}
+
+#endif /* _ENVELOPE_H_ */
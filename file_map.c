@@ -0,0 +1,59 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_map.h"
+
+bool file_map_open(file_map* fm, const char* filename) {
+    fm->p_data = "";
+    fm->size = 0;
+    fm->p_map = NULL;
+    fm->map_size = 0;
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        printf("Error: Could not open file '%s'\n", filename);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        printf("Error: Could not stat file '%s'\n", filename);
+        close(fd);
+        return false;
+    }
+
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* p_map = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+
+    if (p_map == MAP_FAILED) {
+        printf("Error: Could not map file '%s'\n", filename);
+        return false;
+    }
+    madvise(p_map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    fm->p_map = p_map;
+    fm->map_size = (size_t)st.st_size;
+    fm->p_data = (const char*)p_map;
+    fm->size = (size_t)st.st_size;
+    return true;
+}
+
+void file_map_close(file_map* fm) {
+    if (fm->p_map) munmap(fm->p_map, fm->map_size);
+    fm->p_map = NULL;
+    fm->map_size = 0;
+    fm->p_data = "";
+    fm->size = 0;
+}
@@ -0,0 +1,23 @@
+#ifndef _FILE_MAP_H_
+#define _FILE_MAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Read-only memory-mapped file.
+//
+// The mapping is populated up front and advised for sequential access so a
+// parser can walk it straight away without a copy. The data is NOT null
+// terminated; use `size` to bound every read.
+
+typedef struct file_map {
+    const char* p_data;
+    size_t size;
+    void* p_map;      // NULL for empty files
+    size_t map_size;
+} file_map;
+
+bool file_map_open(file_map* fm, const char* filename);
+void file_map_close(file_map* fm);
+
+#endif /* _FILE_MAP_H_ */
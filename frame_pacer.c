@@ -0,0 +1,122 @@
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+#include "frame_pacer.h"
+
+static uint64_t frame_pacer_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static struct timespec frame_pacer_timespec(uint64_t ns) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / 1000000000ull);
+    ts.tv_nsec = (long)(ns % 1000000000ull);
+    return ts;
+}
+
+bool frame_pacer_init(frame_pacer* fp, double fps, int wake_fd) {
+    if (fps <= 0.0) fps = FRAME_PACER_DEFAULT_FPS;
+
+    fp->period_ns = (uint64_t)(1e9 / fps);
+    fp->last_ns = frame_pacer_now();
+    fp->next_ns = fp->last_ns + fp->period_ns;
+    fp->wake_fd = wake_fd;
+    fp->frames = 0;
+    fp->early = 0;
+    fp->missed = 0;
+
+    fp->timer_fd = -1;
+#ifdef __linux__
+    fp->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+#endif
+    // Nothing to wake early for without the timerfd
+    if (fp->timer_fd < 0) fp->wake_fd = -1;
+    return true;
+}
+
+void frame_pacer_free(frame_pacer* fp) {
+    if (fp->timer_fd >= 0) close(fp->timer_fd);
+    fp->timer_fd = -1;
+}
+
+// Sleeps until `deadline`, or less when the wake fd fires (then no later than
+// `earliest`) or a signal arrives. Returns the time it stopped waiting.
+static uint64_t frame_pacer_sleep(frame_pacer* fp, uint64_t deadline, uint64_t earliest) {
+    uint64_t now = frame_pacer_now();
+
+    while (now < deadline) {
+        if (fp->timer_fd < 0) {
+            struct timespec ts = frame_pacer_timespec(deadline);
+            int err = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+            now = frame_pacer_now();
+            if (err == EINTR) break;
+            continue;
+        }
+
+#ifdef __linux__
+        struct itimerspec its = { { 0, 0 }, frame_pacer_timespec(deadline) };
+        timerfd_settime(fp->timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+#endif
+        struct pollfd fds[2] = {
+            { fp->timer_fd, POLLIN, 0 },
+            { fp->wake_fd, POLLIN, 0 },
+        };
+        int ready = poll(fds, fp->wake_fd >= 0 ? 2 : 1, -1);
+        now = frame_pacer_now();
+        if (ready < 0) break; // signal: let the caller look at its flags
+
+        uint64_t count;
+        ssize_t n = 0;
+        if (fds[0].revents & POLLIN) n = read(fp->timer_fd, &count, sizeof(count));
+        if (fp->wake_fd >= 0 && (fds[1].revents & POLLIN)) {
+            n = read(fp->wake_fd, &count, sizeof(count));
+            if (earliest < deadline) deadline = earliest;
+        }
+        (void)n;
+    }
+    return now;
+}
+
+// Clears the wake fd's counter. Anything signalled before the frame starts is
+// handled by that frame, so only wakes after this point may end the next wait.
+static void frame_pacer_drain(frame_pacer* fp) {
+    if (fp->wake_fd < 0) return;
+    uint64_t count;
+    ssize_t n = read(fp->wake_fd, &count, sizeof(count));
+    (void)n;
+}
+
+float frame_pacer_wait(frame_pacer* fp, uint64_t due_ns) {
+    const uint64_t period = fp->period_ns;
+    const uint64_t earliest = fp->last_ns + (uint64_t)(period * FRAME_PACER_MIN_GAP);
+
+    uint64_t deadline = fp->next_ns;
+    if (due_ns < deadline) deadline = due_ns > earliest ? due_ns : earliest;
+    if (frame_pacer_now() >= fp->next_ns) fp->missed++;
+
+    uint64_t now = frame_pacer_sleep(fp, deadline, earliest);
+    frame_pacer_drain(fp);
+
+    if (now < fp->next_ns) {
+        // Started ahead of the grid: the next regular frame is a period away
+        fp->early++;
+        fp->next_ns = now + period;
+    } else {
+        fp->next_ns += period;
+        // Too far behind to catch up, drop the missed deadlines
+        if (fp->next_ns <= now) fp->next_ns = now + period;
+    }
+
+    float dt = (float)((double)(now - fp->last_ns) * 1e-9);
+    if (dt > FRAME_PACER_MAX_DT) dt = FRAME_PACER_MAX_DT;
+    fp->last_ns = now;
+    fp->frames++;
+    return dt;
+}
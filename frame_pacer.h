@@ -0,0 +1,47 @@
+#ifndef _FRAME_PACER_H_
+#define _FRAME_PACER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Frame scheduler on CLOCK_MONOTONIC.
+//
+// Frames start on a fixed grid of absolute deadlines, so the frame period
+// does not grow with the time spent rendering. The wait is a poll() over a
+// timerfd armed with the absolute deadline and an optional wake eventfd (the
+// OSC receiver's): when events arrive the next frame starts right away
+// and the grid is re-anchored there, so a hit is on screen one frame of work
+// after it arrives instead of after the rest of the sleep. Early frames are
+// spaced at least FRAME_PACER_MIN_GAP periods apart so a flood of messages
+// cannot turn the loop into a busy spin. Without timerfd the pacer falls back
+// to clock_nanosleep(TIMER_ABSTIME) and only wakes on the grid.
+
+#define FRAME_PACER_DEFAULT_FPS 60.0
+#define FRAME_PACER_MIN_GAP 0.25 // fraction of a period between early frames
+#define FRAME_PACER_MAX_DT 0.1   // longest step handed to the animation, seconds
+
+typedef struct frame_pacer {
+    uint64_t period_ns;
+    uint64_t next_ns;   // deadline of the next regular frame
+    uint64_t last_ns;   // start of the current frame
+    int timer_fd;       // -1 when falling back to clock_nanosleep
+    int wake_fd;        // -1 when there is nothing to wake early for
+
+    uint64_t frames;
+    uint64_t early;     // frames started by the wake fd or a due time
+    uint64_t missed;    // deadlines that had already passed
+} frame_pacer;
+
+// `wake_fd` may be -1, otherwise a non-blocking eventfd. It is cleared every
+// time a frame starts, so a wake the frame already covers does not start
+// another one. fps <= 0 uses FRAME_PACER_DEFAULT_FPS.
+bool frame_pacer_init(frame_pacer* fp, double fps, int wake_fd);
+void frame_pacer_free(frame_pacer* fp);
+
+// Blocks until the next frame should start: the next deadline, `due_ns` if
+// that is earlier (UINT64_MAX for none), or activity on the wake fd. Returns
+// early on signals too. Returns the seconds since the previous frame start,
+// capped at FRAME_PACER_MAX_DT, for delta-time animation.
+float frame_pacer_wait(frame_pacer* fp, uint64_t due_ns);
+
+#endif /* _FRAME_PACER_H_ */
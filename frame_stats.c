@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "frame_stats.h"
+
+static const char* frame_stage_names[FRAME_STAGE_COUNT] = {
+    "osc", "clear", "transform", "raster", "overlay", "present", "frame",
+};
+
+static inline uint64_t frame_stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int frame_stats_cmp(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+void frame_stats_init(frame_stats* st) {
+    memset(st, 0, sizeof(*st));
+}
+
+void frame_stats_begin(frame_stats* st) {
+    st->begin_ns = frame_stats_now();
+    st->lap_ns = st->begin_ns;
+    memset(st->current, 0, sizeof(st->current));
+}
+
+void frame_stats_lap(frame_stats* st, frame_stage stage) {
+    uint64_t now = frame_stats_now();
+    uint64_t ns = now - st->lap_ns;
+    st->current[stage] += ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+    st->lap_ns = now;
+}
+
+void frame_stats_end(frame_stats* st) {
+    uint64_t total = st->lap_ns - st->begin_ns;
+    st->current[FRAME_STAGE_FRAME] = total > UINT32_MAX ? UINT32_MAX : (uint32_t)total;
+
+    for (int s = 0; s < FRAME_STAGE_COUNT; s++) st->samples[s][st->head] = st->current[s];
+    st->head = (st->head + 1) % FRAME_STATS_WINDOW;
+    if (st->filled < FRAME_STATS_WINDOW) st->filled++;
+    st->frames++;
+}
+
+void frame_stats_summarize(frame_stats* st) {
+    const uint32_t n = st->filled;
+
+    for (int s = 0; s < FRAME_STAGE_COUNT; s++) {
+        frame_stage_summary* sum = &st->summary[s];
+        if (n == 0) {
+            memset(sum, 0, sizeof(*sum));
+            continue;
+        }
+
+        // Ring order does not matter once sorted
+        memcpy(st->scratch, st->samples[s], n * sizeof(uint32_t));
+        qsort(st->scratch, n, sizeof(uint32_t), frame_stats_cmp);
+
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < n; i++) total += st->scratch[i];
+
+        sum->p50_ms = st->scratch[(n - 1) / 2] * 1e-6;
+        sum->p99_ms = st->scratch[(uint32_t)((n - 1) * 0.99)] * 1e-6;
+        sum->max_ms = st->scratch[n - 1] * 1e-6;
+        sum->mean_ms = (double)total / n * 1e-6;
+    }
+}
+
+const char* frame_stage_name(frame_stage stage) {
+    return stage < FRAME_STAGE_COUNT ? frame_stage_names[stage] : "?";
+}
+
+void frame_stats_write_csv_header(FILE* f) {
+    fprintf(f, "time_s,frames,stage,p50_ms,p99_ms,max_ms,mean_ms\n");
+}
+
+void frame_stats_write(const frame_stats* st, FILE* f, double t, bool json) {
+    if (json) {
+        fprintf(f, "{\"time_s\":%.3f,\"frames\":%llu,\"window\":%u", t, (unsigned long long)st->frames, st->filled);
+        for (int s = 0; s < FRAME_STAGE_COUNT; s++) {
+            const frame_stage_summary* sum = &st->summary[s];
+            fprintf(f, ",\"%s\":{\"p50_ms\":%.4f,\"p99_ms\":%.4f,\"max_ms\":%.4f,\"mean_ms\":%.4f}",
+                    frame_stage_names[s], sum->p50_ms, sum->p99_ms, sum->max_ms, sum->mean_ms);
+        }
+        fprintf(f, "}\n");
+    } else {
+        for (int s = 0; s < FRAME_STAGE_COUNT; s++) {
+            const frame_stage_summary* sum = &st->summary[s];
+            fprintf(f, "%.3f,%llu,%s,%.4f,%.4f,%.4f,%.4f\n", t, (unsigned long long)st->frames,
+                    frame_stage_names[s], sum->p50_ms, sum->p99_ms, sum->max_ms, sum->mean_ms);
+        }
+    }
+    fflush(f);
+}
@@ -0,0 +1,74 @@
+#ifndef _FRAME_STATS_H_
+#define _FRAME_STATS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Per-stage frame timing.
+//
+// The render loop calls frame_stats_lap() after each stage. A lap costs one
+// CLOCK_MONOTONIC read (vDSO, no syscall) and stores the time since the
+// previous lap. Every frame's stage times land in a fixed ring of the last
+// FRAME_STATS_WINDOW frames. Percentiles are only computed, by sorting a
+// copy of the ring, when frame_stats_summarize() is called for the overlay or
+// a dump. Nothing is allocated.
+
+#define FRAME_STATS_WINDOW 512 // frames kept per stage
+
+typedef enum frame_stage {
+    FRAME_STAGE_OSC,       // queue drain and scheduler
+    FRAME_STAGE_CLEAR,
+    FRAME_STAGE_TRANSFORM, // projection and facing
+    FRAME_STAGE_RASTER,    // triangles or edges
+    FRAME_STAGE_OVERLAY,   // text on top of the model
+    FRAME_STAGE_PRESENT,
+    FRAME_STAGE_FRAME,     // all of the above, excluding the pacer wait
+    FRAME_STAGE_COUNT
+} frame_stage;
+
+typedef struct frame_stage_summary {
+    double p50_ms;
+    double p99_ms;
+    double max_ms;
+    double mean_ms;
+} frame_stage_summary;
+
+typedef struct frame_stats {
+    uint32_t samples[FRAME_STAGE_COUNT][FRAME_STATS_WINDOW]; // ns
+    uint32_t head;   // next slot to write
+    uint32_t filled; // valid slots, up to FRAME_STATS_WINDOW
+    uint64_t frames;
+
+    // Frame being timed
+    uint64_t begin_ns;
+    uint64_t lap_ns;
+    uint32_t current[FRAME_STAGE_COUNT];
+
+    // Filled in by frame_stats_summarize
+    frame_stage_summary summary[FRAME_STAGE_COUNT];
+    uint32_t scratch[FRAME_STATS_WINDOW];
+} frame_stats;
+
+void frame_stats_init(frame_stats* st);
+
+// Starts timing a frame
+void frame_stats_begin(frame_stats* st);
+
+// Adds the time since the previous lap (or the frame start) to `stage`
+void frame_stats_lap(frame_stats* st, frame_stage stage);
+
+// Stores the frame in the ring
+void frame_stats_end(frame_stats* st);
+
+// Computes p50/p99/max/mean over the ring
+void frame_stats_summarize(frame_stats* st);
+
+const char* frame_stage_name(frame_stage stage);
+
+// Writes the current summary as CSV rows (one per stage) or one JSON line,
+// `t` being seconds since start. Call frame_stats_summarize() first.
+void frame_stats_write_csv_header(FILE* f);
+void frame_stats_write(const frame_stats* st, FILE* f, double t, bool json);
+
+#endif /* _FRAME_STATS_H_ */
@@ -0,0 +1,242 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "framebuffer.h"
+
+fb_glyph fb_glyphs[256];
+
+static void fb_glyph_set(uint8_t id, const char* utf8) {
+    size_t len = strlen(utf8);
+    if (len > sizeof(fb_glyphs[id].utf8)) len = sizeof(fb_glyphs[id].utf8);
+    memcpy(fb_glyphs[id].utf8, utf8, len);
+    fb_glyphs[id].len = (uint8_t)len;
+}
+
+static void fb_glyph_init(void) {
+    static bool initialized = false;
+    if (initialized) return;
+
+    // Unknown ids render as blanks
+    for (int i = 0; i < 256; i++) {
+        fb_glyphs[i].utf8[0] = ' ';
+        fb_glyphs[i].len = 1;
+    }
+    for (int c = 0x20; c < 0x7F; c++) {
+        fb_glyphs[c].utf8[0] = (char)c;
+    }
+    fb_glyph_set(GLYPH_BLOCK, "█");
+    fb_glyph_set(GLYPH_HLINE, "─");
+    fb_glyph_set(GLYPH_LEFT_HALF, "▌");
+
+    initialized = true;
+}
+
+bool fb_init(framebuffer* fb, int width, int height) {
+    size_t count = (size_t)width * (size_t)height;
+
+    fb_glyph_init();
+
+    // Depth plane first so it stays float aligned
+    fb->p_buffer = malloc(count * (sizeof(float) + 2));
+    if (!fb->p_buffer) return false;
+
+    fb->width = width;
+    fb->height = height;
+    fb->depth = (float*)fb->p_buffer;
+    fb->glyph = (uint8_t*)(fb->depth + count);
+    fb->attr = fb->glyph + count;
+
+    fb_clear(fb);
+    return true;
+}
+
+void fb_free(framebuffer* fb) {
+    free(fb->p_buffer);
+    fb->p_buffer = NULL;
+    fb->glyph = NULL;
+    fb->attr = NULL;
+    fb->depth = NULL;
+}
+
+bool fb_resize(framebuffer* fb, int width, int height) {
+    if (width == fb->width && height == fb->height) return true;
+    fb_free(fb);
+    return fb_init(fb, width, height);
+}
+
+void fb_clear(framebuffer* fb) {
+    size_t count = (size_t)fb->width * (size_t)fb->height;
+    float* depth = fb->depth;
+
+    memset(fb->glyph, GLYPH_SPACE, count);
+    memset(fb->attr, FB_COLOR_DEFAULT, count);
+    for (size_t i = 0; i < count; i++) depth[i] = FB_DEPTH_CLEAR;
+}
+
+// Cohen-Sutherland outcodes
+enum {
+    FB_CLIP_LEFT = 1,
+    FB_CLIP_RIGHT = 2,
+    FB_CLIP_TOP = 4,
+    FB_CLIP_BOTTOM = 8
+};
+
+static int fb_outcode(double x, double y, double x_max, double y_max) {
+    int code = 0;
+    if (x < 0.0) code |= FB_CLIP_LEFT;
+    else if (x > x_max) code |= FB_CLIP_RIGHT;
+    if (y < 0.0) code |= FB_CLIP_TOP;
+    else if (y > y_max) code |= FB_CLIP_BOTTOM;
+    return code;
+}
+
+// Clips the segment to the cell grid in place. Returns false when it misses
+// the grid entirely, which includes the trivial bounding box reject.
+static bool fb_clip_line(const framebuffer* fb, double* x0, double* y0, double* x1, double* y1) {
+    const double x_max = fb->width - 1;
+    const double y_max = fb->height - 1;
+    int c0 = fb_outcode(*x0, *y0, x_max, y_max);
+    int c1 = fb_outcode(*x1, *y1, x_max, y_max);
+
+    while (1) {
+        if (!(c0 | c1)) return true;
+        if (c0 & c1) return false;
+
+        int c = c0 ? c0 : c1;
+        double x, y;
+        if (c & FB_CLIP_BOTTOM) {
+            x = *x0 + (*x1 - *x0) * (y_max - *y0) / (*y1 - *y0);
+            y = y_max;
+        } else if (c & FB_CLIP_TOP) {
+            x = *x0 + (*x1 - *x0) * (0.0 - *y0) / (*y1 - *y0);
+            y = 0.0;
+        } else if (c & FB_CLIP_RIGHT) {
+            y = *y0 + (*y1 - *y0) * (x_max - *x0) / (*x1 - *x0);
+            x = x_max;
+        } else {
+            y = *y0 + (*y1 - *y0) * (0.0 - *x0) / (*x1 - *x0);
+            x = 0.0;
+        }
+
+        if (c == c0) {
+            *x0 = x;
+            *y0 = y;
+            c0 = fb_outcode(x, y, x_max, y_max);
+        } else {
+            *x1 = x;
+            *y1 = y;
+            c1 = fb_outcode(x, y, x_max, y_max);
+        }
+    }
+}
+
+void fb_draw_line(framebuffer* fb, int x0, int y0, float z0, int x1, int y1, float z1, uint8_t glyph, uint8_t attr) {
+    fb_draw_line_rows(fb, 0, fb->height - 1, x0, y0, z0, x1, y1, z1, glyph, attr);
+}
+
+void fb_draw_line_rows(framebuffer* fb, int row_min, int row_max, int x0, int y0, float z0, int x1, int y1, float z1,
+                       uint8_t glyph, uint8_t attr) {
+    const int width = fb->width;
+    const int height = fb->height;
+
+    // Clip up front so the raster loop below never leaves the grid
+    if ((unsigned)x0 >= (unsigned)width || (unsigned)y0 >= (unsigned)height ||
+        (unsigned)x1 >= (unsigned)width || (unsigned)y1 >= (unsigned)height) {
+        double cx0 = x0, cy0 = y0, cx1 = x1, cy1 = y1;
+        if (!fb_clip_line(fb, &cx0, &cy0, &cx1, &cy1)) return;
+
+        // Depth follows the clipped endpoints along the original segment
+        double span_x = (double)x1 - x0;
+        double span_y = (double)y1 - y0;
+        double t0 = 0.0, t1 = 1.0;
+        if (fabs(span_x) >= fabs(span_y) && span_x != 0.0) {
+            t0 = (cx0 - x0) / span_x;
+            t1 = (cx1 - x0) / span_x;
+        } else if (span_y != 0.0) {
+            t0 = (cy0 - y0) / span_y;
+            t1 = (cy1 - y0) / span_y;
+        }
+        float dz_total = z1 - z0;
+        z1 = z0 + dz_total * (float)t1;
+        z0 = z0 + dz_total * (float)t0;
+
+        x0 = (int)floor(cx0 + 0.5);
+        y0 = (int)floor(cy0 + 0.5);
+        x1 = (int)floor(cx1 + 0.5);
+        y1 = (int)floor(cy1 + 0.5);
+    }
+
+    int dx = abs(x1 - x0);
+    int dy = abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx - dy;
+
+    float z = z0;
+    float dz = (z1 - z0) / (float)(dx + dy + 1);
+
+    // Rows are visited monotonically, so the walk stops once it leaves the
+    // band and cells before the band are stepped over without writes
+    if (y0 > y1) {
+        if (y1 > row_max || y0 < row_min) return;
+    } else {
+        if (y0 > row_max || y1 < row_min) return;
+    }
+
+    while (1) {
+        if (y0 >= row_min && y0 <= row_max) {
+            int i = y0 * width + x0;
+            if (z > fb->depth[i]) {
+                fb->glyph[i] = glyph;
+                fb->attr[i] = attr;
+                fb->depth[i] = z;
+            }
+        } else if ((sy > 0) == (y0 > row_max)) {
+            break;
+        }
+
+        if (x0 == x1 && y0 == y1) break;
+
+        int e2 = 2 * err;
+        if (e2 > -dy) {
+            err -= dy;
+            x0 += sx;
+        }
+        if (e2 < dx) {
+            err += dx;
+            y0 += sy;
+        }
+        z += dz;
+    }
+}
+
+void fb_draw_text(framebuffer* fb, const char* text, int start_x, int y, uint8_t attr) {
+    const int width = fb->width;
+    int len = (int)strlen(text);
+    if (y < 0 || y >= fb->height || start_x >= width || len == 0) return;
+
+    uint8_t* glyph = fb->glyph + y * width;
+    uint8_t* cell_attr = fb->attr + y * width;
+    float* depth = fb->depth + y * width;
+
+    // Shift everything to the right to make room for text
+    int from = start_x < 0 ? 0 : start_x;
+    int moved = width - (from + len);
+    if (moved > 0) {
+        memmove(glyph + from + len, glyph + from, (size_t)moved);
+        memmove(cell_attr + from + len, cell_attr + from, (size_t)moved);
+        memmove(depth + from + len, depth + from, (size_t)moved * sizeof(float));
+    }
+
+    // Insert the text
+    attr |= FB_ATTR_TEXT;
+    for (int i = 0; i < len && (start_x + i) < width; i++) {
+        if (start_x + i >= 0) {
+            unsigned char c = (unsigned char)text[i];
+            glyph[start_x + i] = (c >= 0x20 && c < 0x7F) ? c : '?';
+            cell_attr[start_x + i] = attr;
+            depth[start_x + i] = FB_DEPTH_TEXT;
+        }
+    }
+}
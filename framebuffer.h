@@ -0,0 +1,68 @@
+#ifndef _FRAMEBUFFER_H_
+#define _FRAMEBUFFER_H_
+
+#include <float.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Byte-coded frame buffer.
+//
+// Cells are stored as three planes carved out of a single allocation: a glyph
+// id, a color/attribute byte and a depth value. Glyph ids are only turned into
+// UTF-8 by the presenter through the glyph table, so the raster and clear
+// paths never touch strings.
+
+// Glyph ids. Printable ASCII (0x20..0x7E) maps to itself.
+enum {
+    GLYPH_SPACE = ' ',
+    GLYPH_BLOCK = 0x80,  // █
+    GLYPH_HLINE,         // ─
+    GLYPH_LEFT_HALF,     // ▌
+    GLYPH_COUNT_
+};
+
+// Cell colors. The low bits of the attribute byte hold one of these.
+enum {
+    FB_COLOR_DEFAULT = 0,
+    FB_COLOR_RED,
+    FB_COLOR_YELLOW,
+    FB_COLOR_WHITE,
+    FB_COLOR_COUNT
+};
+
+#define FB_ATTR_TEXT 0x80 // cell belongs to the text overlay
+#define FB_COLOR_MASK 0x0F
+
+#define FB_DEPTH_CLEAR -1e10f
+#define FB_DEPTH_TEXT FLT_MAX // nothing passes the depth test over text
+
+typedef struct fb_glyph {
+    char utf8[4];
+    uint8_t len;
+} fb_glyph;
+
+typedef struct framebuffer {
+    int width;
+    int height;
+    uint8_t* glyph;  // width * height glyph ids, row major
+    uint8_t* attr;   // width * height color | FB_ATTR_* bytes
+    float* depth;    // width * height depth values, larger wins
+    void* p_buffer;  // single allocation backing all planes
+} framebuffer;
+
+// Glyph id -> UTF-8 table, only used at present time
+extern fb_glyph fb_glyphs[256];
+
+bool fb_init(framebuffer* fb, int width, int height);
+void fb_free(framebuffer* fb);
+bool fb_resize(framebuffer* fb, int width, int height);
+void fb_clear(framebuffer* fb);
+void fb_draw_line(framebuffer* fb, int x0, int y0, float z0, int x1, int y1, float z1, uint8_t glyph, uint8_t attr);
+
+// Same cells as fb_draw_line, but only those in rows [row_min, row_max] are
+// written, so row bands can draw the same line concurrently
+void fb_draw_line_rows(framebuffer* fb, int row_min, int row_max, int x0, int y0, float z0, int x1, int y1, float z1,
+                       uint8_t glyph, uint8_t attr);
+void fb_draw_text(framebuffer* fb, const char* text, int start_x, int y, uint8_t attr);
+
+#endif /* _FRAMEBUFFER_H_ */
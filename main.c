@@ -1,275 +1,300 @@
-#include <arpa/inet.h>
-#include <sys/select.h>
-#include <fcntl.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <termios.h>
 #include <math.h>
 
-#include "objpar.h"
-#include "tinyosc.h"
+#include "deform.h"
+#include "envelope.h"
+#include "frame_pacer.h"
+#include "frame_stats.h"
+#include "framebuffer.h"
+#include "mesh.h"
+#include "mesh_lod.h"
+#include "osc_channels.h"
+#include "osc_rx.h"
+#include "osc_sched.h"
+#include "overlay.h"
+#include "present.h"
+#include "raster.h"
+#include "tile_pool.h"
+#include "transform.h"
 
+// Used when stdout is not a terminal
 #define SCREEN_WIDTH 120
 #define SCREEN_HEIGHT 35
-#define LOG_LINES 8
+
+// Smallest frame that still fits the OSC log overlay
+#define SCREEN_MIN_WIDTH 40
+#define SCREEN_MIN_HEIGHT 8
+
+// Channel lines: at most this many, starting on row CHANNEL_TOP and spaced
+// CHANNEL_SPACING rows apart while they fit
+#define CHANNEL_LINES 48
+#define CHANNEL_TOP 3
+#define CHANNEL_SPACING 3
+#define CHANNEL_RATE_REFRESH_NS 250000000ull // rates and bursts redrawn 4x a second
+#define CHANNEL_BURST_NS 1000000000ull       // burst = events in the last second
+#define CHANNEL_FLASH_LIT 0.35f              // flash level above which a line shows white
+
+// Stats overlay: refresh interval in frames, width in cells
+#define STATS_REFRESH_FRAMES 30
+#define STATS_OVERLAY_W 31
+#define STATS_DUMP_INTERVAL 5.0 // seconds, see --stats-file
+
+// Overlay line slots: one per channel, then the stats box
+#define OVERLAY_LINE_CHANNEL 0
+#define OVERLAY_LINE_STATS CHANNEL_LINES
+
+// Model rotation speed, radians per second (0.02 per frame at 60 fps)
+#define SPIN_RATE 1.2f
+
+// Per-hit envelopes: the channel line flashes, the model kicks in size by
+// SCALE_KICK per unit of gain, all kicks together capped at SCALE_KICK_MAX
+static const envelope_shape flash_shape = { 0.005f, 0.30f };
+static const envelope_shape kick_shape = { 0.010f, 0.15f };
+#define SCALE_KICK 0.06f
+#define SCALE_KICK_MAX 0.3f
 
 // Screen buffer
-char screen[SCREEN_HEIGHT][SCREEN_WIDTH][4];
-float zbuffer[SCREEN_HEIGHT][SCREEN_WIDTH];
-int text_mask[SCREEN_HEIGHT][SCREEN_WIDTH]; // 0 = 3D, 1 = text
-
-// OSC message log
-typedef struct {
-    char address[32];
-    char sound[32];
-    int n;
-    float cycle;
-    float gain;
-    int orbit;
-    char timestamp[16];
-    bool active;
-} OscLog;
-
-OscLog logs[LOG_LINES];
-int log_index = 0;
+framebuffer scene;
+
+// Terminal output
+present_state presenter;
+
+// Coarser copies of the model, see --no-lod
+mesh_lod detail;
+int detail_level = 0;
+
+// OSC-driven vertex displacement, see --deform
+deform_state deformer;
+
+// Screen-space vertices, refreshed once per frame
+xform_cache projected;
+
+// Filled mode triangle bins and wireframe edge bands
+raster_state raster;
+
+// Render threads, see --threads
+tile_pool pool;
+
+// Frame deadlines, see --fps
+frame_pacer pacer;
+
+// Stage timings, shown with --stats or the 's' key
+frame_stats timings;
+
+// Text layer over the model, see --overlay
+overlay text_layer;
+
+// OSC input
+osc_receiver receiver;
+osc_sched scheduler;
+
+// Recent events per (address, orbit)
+osc_channels channels;
+
+// Flashes and kicks started by hits, evaluated once per frame
+envelope_pool envelopes;
 int total_messages = 0;
 
 static volatile bool keepRunning = true;
+static volatile sig_atomic_t screenResized = 0;
 
 static void sigintHandler(int x) {
     keepRunning = false;
 }
 
-char* read_file(const char* filename, unsigned int* out_size) {
-    FILE* file = fopen(filename, "rb");
-    if (!file) {
-        printf("Error: Could not open file '%s'\n", filename);
-        return NULL;
-    }
-    
-    fseek(file, 0, SEEK_END);
-    unsigned int size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    char* buffer = (char*)malloc(size + 1);
-    if (!buffer) {
-        printf("Error: Could not allocate memory\n");
-        fclose(file);
-        return NULL;
-    }
-    
-    fread(buffer, 1, size, file);
-    buffer[size] = '\0';
-    fclose(file);
-    
-    *out_size = size;
-    return buffer;
+static void sigwinchHandler(int x) {
+    (void)x;
+    screenResized = 1;
 }
 
-void clear_screen() {
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            strcpy(screen[y][x], " ");
-            zbuffer[y][x] = -1e10;
-            text_mask[y][x] = 0;
-        }
+// Frame size for the current terminal, leaving room for the presenter's
+// separator and footer rows
+static void screen_size(int* width, int* height) {
+    int cols = SCREEN_WIDTH;
+    int rows = SCREEN_HEIGHT + PRESENT_EXTRA_ROWS;
+    present_terminal_size(&cols, &rows);
+    rows -= PRESENT_EXTRA_ROWS;
+    *width = cols < SCREEN_MIN_WIDTH ? SCREEN_MIN_WIDTH : cols;
+    *height = rows < SCREEN_MIN_HEIGHT ? SCREEN_MIN_HEIGHT : rows;
+}
+
+// Reallocates everything sized by the frame. Only runs on SIGWINCH.
+static bool screen_resize(int width, int height, xform_view* view) {
+    if (!fb_resize(&scene, width, height) ||
+        !present_resize(&presenter, width, height) ||
+        !raster_resize(&raster, width, height)) {
+        return false;
     }
+    if (!overlay_resize(&text_layer, width)) return false;
+    xform_view_fit(view, width, height);
+    return true;
 }
 
-void draw_text_into_scene(const char* text, int start_x, int y, int color_type) {
-    int len = strlen(text);
-    if (y < 0 || y >= SCREEN_HEIGHT || start_x >= SCREEN_WIDTH) return;
-    
-    // Shift everything to the right to make room for text
-    for (int x = SCREEN_WIDTH - 1; x >= start_x + len; x--) {
-        if (x - len >= 0) {
-            strcpy(screen[y][x], screen[y][x - len]);
-            zbuffer[y][x] = zbuffer[y][x - len];
-            text_mask[y][x] = text_mask[y][x - len];
+// Single keys without echo or line buffering; stdin stays a terminal
+static struct termios saved_termios;
+static bool input_raw = false;
+
+static void input_init(void) {
+    if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &saved_termios) != 0) return;
+    struct termios raw = saved_termios;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_cc[VMIN] = 0;
+    raw.c_cc[VTIME] = 0;
+    input_raw = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+}
+
+static void input_restore(void) {
+    if (input_raw) tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+}
+
+// Next pending key, -1 when there is none
+static int input_key(void) {
+    unsigned char c;
+    if (input_raw && read(STDIN_FILENO, &c, 1) == 1) return c;
+    return -1;
+}
+
+// Rebuilds the stats box, top right, from the last summary
+static void build_stats_lines(bool visible) {
+    char line[64];
+    int x = scene.width - STATS_OVERLAY_W;
+    if (x < 0) x = 0;
+
+    for (int s = 0; s <= FRAME_STAGE_COUNT; s++) {
+        int slot = OVERLAY_LINE_STATS + s;
+        if (!visible) {
+            overlay_line_hide(&text_layer, slot);
+            continue;
         }
-    }
-    
-    // Insert the text
-    for (int i = 0; i < len && (start_x + i) < SCREEN_WIDTH; i++) {
-        if (start_x + i >= 0) {
-            char buf[4];
-            snprintf(buf, sizeof(buf), "%c", text[i]);
-            strcpy(screen[y][start_x + i], buf);
-            text_mask[y][start_x + i] = 1;
-            zbuffer[y][start_x + i] = 1e10;
+        int len;
+        if (s == 0) {
+            len = snprintf(line, sizeof(line), "%-9s %6s %6s %6s", "ms", "p50", "p99", "max");
+        } else {
+            const frame_stage_summary* sum = &timings.summary[s - 1];
+            len = snprintf(line, sizeof(line), "%-9s %6.2f %6.2f %6.2f", frame_stage_name(s - 1),
+                           sum->p50_ms, sum->p99_ms, sum->max_ms);
         }
+        overlay_line_begin(&text_layer, slot, s);
+        overlay_line_add(&text_layer, slot, x, line, len, FB_COLOR_WHITE);
     }
 }
 
-int get_text_offset(int x, int y) {
-    return 0; // Not needed anymore since we're literally displacing
+// Rebuilds the overlay line of channel `i` on row `y`. Only runs when the
+// channel got events, its flash toggled, the layout moved or the rates are
+// due for a refresh.
+static void build_channel_line(int i, int y, uint64_t now_ns, uint8_t color) {
+    const osc_channel* c = &channels.channels[i];
+    const osc_event* ev = osc_channel_latest(c);
+    int slot = OVERLAY_LINE_CHANNEL + i;
+    char buf[32];
+    int len;
+
+    overlay_line_begin(&text_layer, slot, y);
+
+    // Orbit number
+    len = snprintf(buf, sizeof(buf), "[%d]", c->orbit);
+    overlay_line_add(&text_layer, slot, 5, buf, len, color);
+
+    // Sound name, or the address for sources that do not send one
+    const char* label = ev->sound[0] ? ev->sound : c->address;
+    overlay_line_add(&text_layer, slot, 10, label, (int)strnlen(label, sizeof(ev->sound)), color);
+
+    // n value
+    len = snprintf(buf, sizeof(buf), "n:%d", ev->n);
+    overlay_line_add(&text_layer, slot, 25, buf, len, color);
+
+    // cycle as progress bar
+    const int bar_length = 10;
+    int filled = (int)((ev->cycle - (int)ev->cycle) * bar_length);
+    if (filled < 0) filled = 0;
+    buf[0] = '[';
+    memset(buf + 1, '#', (size_t)filled);
+    memset(buf + 1 + filled, '-', (size_t)(bar_length - filled));
+    buf[bar_length + 1] = ']';
+    overlay_line_add(&text_layer, slot, 33, buf, bar_length + 2, color);
+
+    // gain
+    len = snprintf(buf, sizeof(buf), "g:%.2f", ev->gain);
+    overlay_line_add(&text_layer, slot, 46, buf, len, color);
+
+    // Rate over the ring and the burst size in the last second
+    len = snprintf(buf, sizeof(buf), "%.1f/s x%u", osc_channel_rate(c, now_ns),
+                   osc_channel_recent(c, now_ns, CHANNEL_BURST_NS));
+    overlay_line_add(&text_layer, slot, 54, buf, len, color);
 }
 
-void display_screen() {
-    printf("\033[2J\033[H");
-    
-    // Draw everything
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            if (text_mask[y][x] == 1) {
-                // Black text
-                printf("\033[33m%s\033[0m", screen[y][x]);
-            } else if (strcmp(screen[y][x], "█") == 0) {
-                // Red wireframe
-                printf("\033[31m%s\033[0m", screen[y][x]);
-            } else {
-                printf("%s", screen[y][x]);
-            }
-        }
-        putchar('\n');
+// Places one line per channel, in order of first appearance, squeezing the
+// spacing when they do not fit. Lines are only rebuilt when needed.
+static void update_channel_lines(uint64_t now_ns) {
+    static uint32_t shown = 0;
+    static int shown_spacing = 0;
+    static int shown_height = 0;
+    static uint64_t next_refresh_ns = 0;
+    static bool lit[CHANNEL_LINES];
+
+    uint32_t count = channels.count < CHANNEL_LINES ? channels.count : CHANNEL_LINES;
+    int rows = scene.height - CHANNEL_TOP;
+    int spacing = CHANNEL_SPACING;
+    while (spacing > 1 && (int)count * spacing > rows) spacing--;
+    uint32_t visible = rows <= 0 ? 0 : (uint32_t)((rows + spacing - 1) / spacing);
+    if (visible > count) visible = count;
+
+    bool relayout = visible != shown || spacing != shown_spacing || scene.height != shown_height;
+    bool refresh = now_ns >= next_refresh_ns;
+    if (refresh) next_refresh_ns = now_ns + CHANNEL_RATE_REFRESH_NS;
+
+    for (uint32_t i = 0; i < visible; i++) {
+        osc_channel* c = &channels.channels[i];
+        bool on = envelope_owned(&envelopes, (int)i, ENVELOPE_FLASH) > CHANNEL_FLASH_LIT;
+        if (!c->dirty && on == lit[i] && !relayout && !refresh) continue;
+        build_channel_line((int)i, CHANNEL_TOP + (int)i * spacing, now_ns, on ? FB_COLOR_WHITE : FB_COLOR_YELLOW);
+        c->dirty = false;
+        lit[i] = on;
     }
-    
-    // Bottom info
-    printf("\033[37m");
-    for (int i = 0; i < SCREEN_WIDTH; i++) printf("─");
-    printf("\033[0m\n");
-    printf("\033[31m▌\033[0m \033[37mOSC MESSAGES: %d\033[0m\n", total_messages);
+    for (uint32_t i = visible; i < shown; i++) overlay_line_hide(&text_layer, OVERLAY_LINE_CHANNEL + (int)i);
+
+    shown = visible;
+    shown_spacing = spacing;
+    shown_height = scene.height;
 }
 
-void project(float x, float y, float z, int* sx, int* sy) {
-    float scale = 20.0f;
-    float distance = 4.0f;
-    float factor = scale / (z + distance);
-    *sx = (int)(x * factor) + SCREEN_WIDTH / 2;
-    *sy = (int)(y * factor) + SCREEN_HEIGHT / 2;
+int get_text_offset(int x, int y) {
+    return 0; // Not needed anymore since we're literally displacing
 }
 
-void draw_line(int x0, int y0, float z0, int x1, int y1, float z1, const char* ch) {
-    int dx = abs(x1 - x0);
-    int dy = abs(y1 - y0);
-    int sx = x0 < x1 ? 1 : -1;
-    int sy = y0 < y1 ? 1 : -1;
-    int err = dx - dy;
-    
-    float z = z0;
-    float dz = (z1 - z0) / (float)(dx + dy + 1);
-    
-    while (1) {
-        if (x0 >= 0 && x0 < SCREEN_WIDTH && y0 >= 0 && y0 < SCREEN_HEIGHT) {
-            if (z > zbuffer[y0][x0] && text_mask[y0][x0] == 0) {
-                strcpy(screen[y0][x0], ch);
-                zbuffer[y0][x0] = z;
-            }
-        }
-        
-        if (x0 == x1 && y0 == y1) break;
-        
-        int e2 = 2 * err;
-        if (e2 > -dy) {
-            err -= dy;
-            x0 += sx;
-        }
-        if (e2 < dx) {
-            err += dx;
-            y0 += sy;
-        }
-        z += dz;
-    }
+// Pool jobs, `ctx` is the mesh as deformed this frame. Each one only writes its own tile or band.
+static void render_tile_job(void* ctx, int tile) {
+    raster_tile(&raster, &scene, (const mesh*)ctx, &projected, tile, FB_COLOR_RED);
 }
 
-void rotate_y(float* x, float* y, float* z, float angle) {
-    float cos_a = cos(angle);
-    float sin_a = sin(angle);
-    float nx = *x * cos_a + *z * sin_a;
-    float nz = -*x * sin_a + *z * cos_a;
-    *x = nx;
-    *z = nz;
+static void render_band_job(void* ctx, int band) {
+    raster_band_edges(&raster, &scene, (const mesh*)ctx, &projected, band, GLYPH_BLOCK, FB_COLOR_RED);
 }
 
-void rotate_x(float* x, float* y, float* z, float angle) {
-    float cos_a = cos(angle);
-    float sin_a = sin(angle);
-    float ny = *y * cos_a - *z * sin_a;
-    float nz = *y * sin_a + *z * cos_a;
-    *y = ny;
-    *z = nz;
+void display_screen() {
+    // Bottom info
+    char footer[PRESENT_FOOTER_MAX];
+    osc_rx_stats stats;
+    osc_rx_get_stats(&receiver, &stats);
+    snprintf(footer, sizeof(footer), "\033[31m▌\033[0m \033[37mOSC MESSAGES: %d  CH:%u  ENV:%u  LOD:%d  Q:%u/%u  SCHED:%u  DROP:%llu  LAT:%.1fms\033[0m",
+             total_messages, channels.count, envelopes.active_count, detail_level, stats.depth, stats.depth_max, scheduler.count,
+             (unsigned long long)(stats.dropped + channels.rejected + envelopes.dropped + scheduler.rejected), stats.latency_ms);
+    
+    present_frame(&presenter, &scene, footer);
+    osc_rx_presented(&receiver, osc_now_ns());
 }
 
-void add_osc_log(const char* address, tosc_message* msg) {
-    if (!address || !msg) return;
-    
-    // First parse to get orbit number
-    int target_orbit = 0;
-    const char* format = tosc_getFormat(msg);
-    if (!format) return;
-    
-    tosc_reset(msg);
-    
-    // Quick scan for orbit value
-    for (int i = 0; format[i] != '\0' && i < 100; i++) {
-        if (format[i] == 's') {
-            const char* str = tosc_getNextString(msg);
-            if (str && strcmp(str, "orbit") == 0 && i + 1 < 100 && format[i+1] == 'i') {
-                target_orbit = tosc_getNextInt32(msg);
-                break;
-            }
-        } else if (format[i] == 'i') {
-            tosc_getNextInt32(msg);
-        } else if (format[i] == 'f') {
-            tosc_getNextFloat(msg);
-        }
-    }
-    
-    // Use orbit as the index (clamped to LOG_LINES)
-    if (target_orbit >= LOG_LINES) target_orbit = LOG_LINES - 1;
-    OscLog* log = &logs[target_orbit];
-    
-    strncpy(log->address, address, 31);
-    log->address[31] = '\0';
-    
-    strcpy(log->sound, "???");
-    log->n = 0;
-    log->cycle = 0.0f;
-    log->gain = 1.0f;
-    log->orbit = target_orbit;
-    log->active = true;
-    
-    tosc_reset(msg);
-    
-    // Parse all values
-    int i = 0;
-    while (format[i] != '\0' && i < 100) {
-        if (format[i] == 's') {
-            const char* str = tosc_getNextString(msg);
-            if (str) {
-                if (strcmp(str, "s") == 0 && i + 1 < 100 && format[i+1] == 's') {
-                    const char* sound = tosc_getNextString(msg);
-                    if (sound) {
-                        strncpy(log->sound, sound, 31);
-                        log->sound[31] = '\0';
-                    }
-                    i++;
-                } else if (strcmp(str, "n") == 0 && i + 1 < 100 && format[i+1] == 'i') {
-                    log->n = tosc_getNextInt32(msg);
-                    i++;
-                } else if (strcmp(str, "cycle") == 0 && i + 1 < 100 && format[i+1] == 'f') {
-                    log->cycle = tosc_getNextFloat(msg);
-                    i++;
-                } else if (strcmp(str, "gain") == 0 && i + 1 < 100 && format[i+1] == 'f') {
-                    log->gain = tosc_getNextFloat(msg);
-                    i++;
-                }
-            }
-        } else if (format[i] == 'i') {
-            tosc_getNextInt32(msg);
-        } else if (format[i] == 'f') {
-            tosc_getNextFloat(msg);
-        }
-        i++;
-    }
-    
-    snprintf(log->timestamp, 16, "%02d:%02d", 
-             (total_messages / 60) % 60, 
-             total_messages % 60);
-    
+void add_osc_log(const osc_event* ev, uint64_t now_ns) {
+    osc_channel* c = osc_channels_record(&channels, ev);
+    if (c) envelope_start(&envelopes, ENVELOPE_FLASH, (int)(c - channels.channels), &flash_shape, ev->gain, now_ns);
+    envelope_start(&envelopes, ENVELOPE_SCALE, ENVELOPE_NO_OWNER, &kick_shape, SCALE_KICK * ev->gain, now_ns);
+    deform_trigger(&deformer, ev);
     total_messages++;
 }
 
@@ -277,180 +302,242 @@ int main(int argc, char *argv[]) {
     printf("ASCII OBJ + OSC Corrupted Renderer\n");
     printf("===================================\n\n");
     
-    if (argc < 2) {
-        printf("Usage: %s <objfile.obj>\n", argv[0]);
-        return 1;
+    const char* filename = NULL;
+    bool hidden_lines = false;
+    bool filled = false;
+    int threads = 1;
+    double fps = FRAME_PACER_DEFAULT_FPS;
+    bool show_stats = false;
+    overlay_mode text_mode = OVERLAY_DISPLACE;
+    const char* stats_path = NULL;
+    const char* deform_path = NULL;
+    bool use_lod = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hidden-lines") == 0) hidden_lines = true;
+        else if (strcmp(argv[i], "--filled") == 0) filled = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) fps = atof(argv[++i]);
+        else if (strcmp(argv[i], "--stats") == 0) show_stats = true;
+        else if (strcmp(argv[i], "--overlay") == 0 && i + 1 < argc) {
+            if (!overlay_parse_mode(argv[++i], &text_mode)) {
+                printf("Unknown overlay mode %s (displace, overwrite or behind)\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--stats-file") == 0 && i + 1 < argc) stats_path = argv[++i];
+        else if (strcmp(argv[i], "--deform") == 0 && i + 1 < argc) deform_path = argv[++i];
+        else if (strcmp(argv[i], "--no-lod") == 0) use_lod = false;
+        else filename = argv[i];
     }
     
-    const char* filename = argv[1];
-    printf("Loading: %s\n", filename);
-    
-    unsigned int file_size;
-    char* obj_data = read_file(filename, &file_size);
-    if (!obj_data) return 1;
-    
-    unsigned int buffer_size = objpar_get_size(obj_data, file_size);
-    if (buffer_size == 0) {
-        printf("Error: Invalid OBJ file\n");
-        free(obj_data);
+    if (!filename) {
+        printf("Usage: %s [--hidden-lines | --filled] [--threads N (0 = all cores)] [--fps N] [--stats] [--stats-file out.csv|out.json]\n"
+               "       [--overlay displace|overwrite|behind] [--deform mappings.conf] [--no-lod] <objfile.obj>\n", argv[0]);
         return 1;
     }
     
-    void* buffer = malloc(buffer_size);
-    if (!buffer) {
-        printf("Error: Could not allocate buffer\n");
-        free(obj_data);
-        return 1;
-    }
+    if (!deform_load(&deformer, deform_path)) return 1;
     
-    struct objpar_data parsed_data;
-    unsigned int result = objpar(obj_data, file_size, buffer, &parsed_data);
+    printf("Loading: %s\n", filename);
     
-    if (!result) {
-        printf("Failed to parse OBJ\n");
-        free(buffer);
-        free(obj_data);
-        return 1;
-    }
+    mesh model;
+    if (!mesh_load(&model, filename)) return 1;
     
-    printf("Vertices: %u, Faces: %u\n", parsed_data.position_count, parsed_data.face_count);
+    printf("Vertices: %u, Faces: %u, Edges: %u%s\n", model.vertex_count, model.face_count,
+           model.edge_count, model.from_cache ? " (cached)" : "");
     
-    if (parsed_data.position_width != 3) {
-        printf("ERROR: Position width is not 3!\n");
-        free(buffer);
-        free(obj_data);
-        return 1;
+    // With --no-lod only the model itself, nothing coarser is built
+    if (use_lod) mesh_lod_build(&detail, &model);
+    else mesh_lod_init(&detail, &model);
+    for (int i = 1; i < detail.level_count; i++) {
+        printf("LOD %d: %u vertices, %u edges (grid %d)\n", i, detail.levels[i]->vertex_count,
+               detail.levels[i]->edge_count, detail.grid[i]);
     }
     
-    if (parsed_data.face_width != 3 && parsed_data.face_width != 4) {
-        printf("ERROR: Face width must be 3 or 4.\n");
-        free(buffer);
-        free(obj_data);
+    // OSC setup
+    signal(SIGINT, &sigintHandler);
+    signal(SIGWINCH, &sigwinchHandler);
+    if (!osc_rx_start(&receiver, 9000, OSC_RX_BATCH_RECV)) {
+        mesh_lod_free(&detail);
+        mesh_free(&model);
         return 1;
     }
+    // Periodic stats dump, JSON lines when the name ends in .json
+    FILE* stats_file = NULL;
+    bool stats_json = false;
+    if (stats_path) {
+        size_t len = strlen(stats_path);
+        stats_json = len >= 5 && strcmp(stats_path + len - 5, ".json") == 0;
+        stats_file = fopen(stats_path, "w");
+        if (!stats_file) printf("Warning: Could not open %s, stats will not be written\n", stats_path);
+        else if (!stats_json) frame_stats_write_csv_header(stats_file);
+    }
     
-    // OSC setup
-    signal(SIGINT, &sigintHandler);
-    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
-    fcntl(fd, F_SETFL, O_NONBLOCK);
-    struct sockaddr_in sin;
-    sin.sin_family = AF_INET;
-    sin.sin_port = htons(9000);
-    sin.sin_addr.s_addr = INADDR_ANY;
-    bind(fd, (struct sockaddr*)&sin, sizeof(struct sockaddr_in));
     printf("Listening on port 9000\n");
     printf("Starting render...\n\n");
     
-    // Initialize logs
-    for (int i = 0; i < LOG_LINES; i++) {
-        logs[i].active = false;
-        logs[i].address[0] = '\0';
-        logs[i].sound[0] = '\0';
-        logs[i].orbit = i;
-    }
+    osc_sched_init(&scheduler);
+    
+    osc_channels_init(&channels);
+    envelope_pool_init(&envelopes);
     
     sleep(1);
     
-    char osc_buffer[2048];
+    int screen_w, screen_h;
+    screen_size(&screen_w, &screen_h);
+    if (!fb_init(&scene, screen_w, screen_h) ||
+        !present_init(&presenter, screen_w, screen_h) ||
+        !deform_init(&deformer, &model, hidden_lines || filled) ||
+        !xform_cache_init(&projected, model.vertex_count, model.tri_count) ||
+        !raster_init(&raster, screen_w, screen_h, model.tri_count) ||
+        !overlay_init(&text_layer, screen_w, text_mode) ||
+        !tile_pool_init(&pool, threads)) {
+        printf("Error: Could not allocate screen buffers\n");
+        if (stats_file) fclose(stats_file);
+        overlay_free(&text_layer);
+        raster_free(&raster);
+        xform_cache_free(&projected);
+        deform_free(&deformer);
+        mesh_lod_free(&detail);
+        present_free(&presenter);
+        fb_free(&scene);
+        osc_rx_stop(&receiver);
+        mesh_free(&model);
+        return 1;
+    }
+    fflush(stdout);
+    
     float angle = 0.0f;
+    xform_view view;
+    xform_view_fit(&view, screen_w, screen_h);
+    frame_pacer_init(&pacer, fps, receiver.wake_fd);
+    frame_stats_init(&timings);
+    input_init();
+    build_stats_lines(show_stats);
+    uint64_t start_ns = osc_now_ns();
+    uint64_t next_dump_ns = start_ns + (uint64_t)(STATS_DUMP_INTERVAL * 1e9);
     
     while (keepRunning) {
-        // Check for OSC messages
-        int len = recvfrom(fd, osc_buffer, sizeof(osc_buffer), 0, NULL, NULL);
-        if (len > 0) {
-            tosc_message msg;
-            if (tosc_parseMessage(&msg, osc_buffer, len) == 0) {
-                add_osc_log(tosc_getAddress(&msg), &msg);
+        if (screenResized) {
+            screenResized = 0;
+            screen_size(&screen_w, &screen_h);
+            if (!screen_resize(screen_w, screen_h, &view)) {
+                printf("Error: Could not resize screen buffers\n");
+                break;
+            }
+            build_stats_lines(show_stats);
+        }
+        
+        for (int key; (key = input_key()) >= 0;) {
+            if (key == 's' || key == 'S') {
+                show_stats = !show_stats;
+                frame_stats_summarize(&timings);
+                build_stats_lines(show_stats);
             }
         }
         
-        clear_screen();
+        frame_stats_begin(&timings);
         
-        // Render 3D model FIRST
-        for (unsigned int i = 0; i < parsed_data.face_count; i++) {
-            unsigned int face_offset = i * parsed_data.face_width * 3;
-            unsigned int num_edges = parsed_data.face_width;
-            
-            for (unsigned int edge = 0; edge < num_edges; edge++) {
-                unsigned int v0_idx = parsed_data.p_faces[face_offset + edge * 3] - 1;
-                unsigned int v1_idx = parsed_data.p_faces[face_offset + ((edge + 1) % num_edges) * 3] - 1;
-                
-                float x0 = parsed_data.p_positions[v0_idx * parsed_data.position_width];
-                float y0 = parsed_data.p_positions[v0_idx * parsed_data.position_width + 1];
-                float z0 = parsed_data.p_positions[v0_idx * parsed_data.position_width + 2];
-                
-                float x1 = parsed_data.p_positions[v1_idx * parsed_data.position_width];
-                float y1 = parsed_data.p_positions[v1_idx * parsed_data.position_width + 1];
-                float z1 = parsed_data.p_positions[v1_idx * parsed_data.position_width + 2];
-                
-                rotate_y(&x0, &y0, &z0, angle);
-                rotate_x(&x0, &y0, &z0, angle * 0.7f);
-                rotate_y(&x1, &y1, &z1, angle);
-                rotate_x(&x1, &y1, &z1, angle * 0.7f);
-                
-                int sx0, sy0, sx1, sy1;
-                project(x0, y0, z0, &sx0, &sy0);
-                project(x1, y1, z1, &sx1, &sy1);
-                
-                draw_line(sx0, sy0, z0, sx1, sy1, z1, "█");
+        // Apply everything the receiver thread queued since the last frame,
+        // holding back bundle events until their timetag. Held events that
+        // fell due go first when they are older than the queued event.
+        uint64_t now = osc_now_ns();
+        osc_event ev, held;
+        while (osc_rx_pop(&receiver, &ev)) {
+            if (ev.due_ns > now && osc_sched_push(&scheduler, &ev, now)) continue;
+            uint64_t at = ev.due_ns ? ev.due_ns : ev.recv_ns;
+            if (at > now) at = now;
+            while (osc_sched_pop_due(&scheduler, at, &held)) {
+                add_osc_log(&held, now);
+                osc_rx_applied(&receiver, &held);
             }
+            add_osc_log(&ev, now);
+            osc_rx_applied(&receiver, &ev);
         }
+        while (osc_sched_pop_due(&scheduler, now, &ev)) {
+            add_osc_log(&ev, now);
+            osc_rx_applied(&receiver, &ev);
+        }
+        envelope_update(&envelopes, now);
+        frame_stats_lap(&timings, FRAME_STAGE_OSC);
+        
+        fb_clear(&scene);
+        frame_stats_lap(&timings, FRAME_STAGE_CLEAR);
         
-        // Draw OSC messages OVER the 3D - one line per orbit
-        for (int i = 0; i < LOG_LINES; i++) {
-            if (logs[i].active) {
-                int text_y = 3 + (i * 3);
-                int x_pos = 5;
-                
-                // Orbit number
-                char orbit_buf[8];
-                snprintf(orbit_buf, sizeof(orbit_buf), "[%d]", logs[i].orbit);
-                draw_text_into_scene(orbit_buf, x_pos, text_y, 1);
-                x_pos += 5;
-                
-                // Sound name
-                draw_text_into_scene(logs[i].sound, x_pos, text_y, 1);
-                x_pos += 15;
-                
-                // n value
-                char n_buf[16];
-                snprintf(n_buf, sizeof(n_buf), "n:%d", logs[i].n);
-                draw_text_into_scene(n_buf, x_pos, text_y, 1);
-                x_pos += 8;
-                
-                // cycle as progress bar
-                float cycle_frac = logs[i].cycle - (int)logs[i].cycle;
-                int bar_length = 10;
-                int filled = (int)(cycle_frac * bar_length);
-                
-                char cyc_buf[64] = "[";
-                for (int b = 0; b < bar_length; b++) {
-                    if (b < filled) {
-                        strcat(cyc_buf, "#");
-                    } else {
-                        strcat(cyc_buf, "-");
-                    }
-                }
-                strcat(cyc_buf, "]");
-                draw_text_into_scene(cyc_buf, x_pos, text_y, 1);
-                x_pos += 13;
-                
-                // gain
-                char gain_buf[16];
-                snprintf(gain_buf, sizeof(gain_buf), "g:%.2f", logs[i].gain);
-                draw_text_into_scene(gain_buf, x_pos, text_y, 1);
+        // Render 3D model FIRST, at the detail the screen can show and
+        // displaced by whatever is playing. The level ignores scale kicks so
+        // it does not flip back and forth on every hit.
+        detail_level = mesh_lod_select(&detail, view.scale, view.distance);
+        xform_view kicked = view;
+        kicked.scale *= 1.0f + fminf(envelopes.total[ENVELOPE_SCALE], SCALE_KICK_MAX);
+        const mesh* shape = deform_apply(&deformer, detail.levels[detail_level]);
+        xform_mat3 rotation;
+        xform_rotation(&rotation, angle, angle * 0.7f);
+        xform_project(&projected, shape, &rotation, &kicked);
+        if (hidden_lines || filled) xform_facing(&projected, shape, &rotation, &kicked);
+        frame_stats_lap(&timings, FRAME_STAGE_TRANSFORM);
+        
+        if (filled) {
+            if (raster_prepare(&raster, shape, &projected, &rotation)) {
+                tile_pool_run(&pool, raster.tiles_x * raster.tiles_y, render_tile_job, (void*)shape);
+            }
+        } else if (pool.thread_count > 1) {
+            if (raster_prepare_edges(&raster, shape, &projected, hidden_lines)) {
+                tile_pool_run(&pool, raster.tiles_y, render_band_job, (void*)shape);
+            }
+        } else {
+            for (uint32_t e = 0; e < shape->edge_count; e++) {
+                if (hidden_lines && !xform_edge_front(&projected, shape, e)) continue;
+                uint32_t v0 = shape->edges[e * 2];
+                uint32_t v1 = shape->edges[e * 2 + 1];
+                fb_draw_line(&scene, projected.sx[v0], projected.sy[v0], projected.depth[v0],
+                             projected.sx[v1], projected.sy[v1], projected.depth[v1], GLYPH_BLOCK, FB_COLOR_RED);
             }
         }
+        frame_stats_lap(&timings, FRAME_STAGE_RASTER);
+        
+        // OSC messages OVER the 3D - one line per channel
+        update_channel_lines(osc_now_ns());
+        overlay_composite(&text_layer, &scene);
+        frame_stats_lap(&timings, FRAME_STAGE_OVERLAY);
         
         display_screen();
-        angle += 0.02f;
+        frame_stats_lap(&timings, FRAME_STAGE_PRESENT);
+        frame_stats_end(&timings);
+        
+        // Percentiles are only worked out when something shows them
+        uint64_t frame_end = osc_now_ns();
+        bool dump = stats_file && frame_end >= next_dump_ns;
+        if (dump || (show_stats && timings.frames % STATS_REFRESH_FRAMES == 0)) {
+            frame_stats_summarize(&timings);
+            build_stats_lines(show_stats);
+        }
+        if (dump) {
+            frame_stats_write(&timings, stats_file, (frame_end - start_ns) * 1e-9, stats_json);
+            next_dump_ns = frame_end + (uint64_t)(STATS_DUMP_INTERVAL * 1e9);
+        }
         
-        usleep(16666); // ~60 FPS
+        // Sleep until the next frame, a scheduled bundle or an OSC hit, then
+        // advance the animation by the time that actually passed
+        float dt = frame_pacer_wait(&pacer, osc_sched_next_due(&scheduler));
+        deform_update(&deformer, dt);
+        angle += (SPIN_RATE + deformer.amount[DEFORM_SPIN]) * dt;
     }
     
-    close(fd);
-    free(buffer);
-    free(obj_data);
+    input_restore();
+    present_restore_terminal(&presenter);
+    if (stats_file) fclose(stats_file);
+    present_free(&presenter);
+    frame_pacer_free(&pacer);
+    tile_pool_free(&pool);
+    overlay_free(&text_layer);
+    raster_free(&raster);
+    xform_cache_free(&projected);
+    deform_free(&deformer);
+    mesh_lod_free(&detail);
+    fb_free(&scene);
+    osc_rx_stop(&receiver);
+    mesh_free(&model);
     
     return 0;
 }
@@ -0,0 +1,56 @@
+#ifndef _MESH_H_
+#define _MESH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "file_map.h"
+
+// Render-ready mesh: SoA positions plus a deduplicated edge list.
+//
+// Faces are also kept fan-triangulated, with one plane per triangle and the
+// (up to) two triangles adjacent to every edge, for culling and filling.
+//
+// mesh_load() keeps a binary cache next to the source OBJ ("<obj>.osc-mesh").
+// The cache is a header followed by the position, edge and triangle arrays,
+// each starting on a MESH_ALIGN boundary. A cache whose recorded source size
+// and mtime match the OBJ's is mapped and used in place without reading the
+// OBJ, once every index in it is checked to be in range. When only the mtime
+// differs the OBJ is hashed and the cache still used if the content is
+// unchanged; otherwise the OBJ is parsed and the cache rewritten.
+
+#define MESH_ALIGN 64
+#define MESH_CACHE_SUFFIX ".osc-mesh"
+#define MESH_TRI_NONE UINT32_MAX
+
+typedef struct mesh {
+    const float* x;
+    const float* y;
+    const float* z;
+    const uint32_t* edges;     // edge_count pairs of zero-based vertex indices, a < b
+    const uint32_t* edge_tris; // edge_count pairs of adjacent triangles or MESH_TRI_NONE
+    const uint32_t* tris;      // tri_count vertex index triples
+    const float* tri_nx;       // per triangle unit normal (b - a) x (c - a) ...
+    const float* tri_ny;
+    const float* tri_nz;
+    const float* tri_d;        // ... and plane offset n.a
+    uint32_t vertex_count;
+    uint32_t edge_count;
+    uint32_t face_count;
+    uint32_t tri_count;
+    bool from_cache;
+
+    void* p_image;             // built image, NULL when mapped from the cache
+    file_map map;
+} mesh;
+
+bool mesh_load(mesh* m, const char* obj_path);
+void mesh_free(mesh* m);
+
+// Builds a mesh from arrays laid out like the fields above, computing the
+// triangle planes. Every triangle counts as one face. Nothing is cached.
+bool mesh_assemble(mesh* m, const float* x, const float* y, const float* z, uint32_t vertex_count,
+                   const uint32_t* edges, const uint32_t* edge_tris, uint32_t edge_count,
+                   const uint32_t* tris, uint32_t tri_count);
+
+#endif /* _MESH_H_ */
@@ -0,0 +1,313 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "mesh_lod.h"
+
+#define MESH_LOD_EMPTY UINT32_MAX
+
+// Open addressing map from 64-bit keys to ids, MESH_LOD_EMPTY marking free
+// slots. Sized once for the largest level and cleared between uses.
+typedef struct mesh_lod_map {
+    uint64_t* keys;
+    uint32_t* ids;
+    size_t mask;
+    unsigned int shift;
+} mesh_lod_map;
+
+static bool mesh_lod_map_init(mesh_lod_map* map, size_t count) {
+    size_t slots = 16;
+    unsigned int bits = 4;
+    while (slots < count * 2) {
+        slots <<= 1;
+        bits++;
+    }
+    map->keys = malloc(slots * sizeof(uint64_t));
+    map->ids = malloc(slots * sizeof(uint32_t));
+    map->mask = slots - 1;
+    map->shift = 64 - bits;
+    return map->keys && map->ids;
+}
+
+static void mesh_lod_map_free(mesh_lod_map* map) {
+    free(map->keys);
+    free(map->ids);
+}
+
+static void mesh_lod_map_clear(mesh_lod_map* map) {
+    memset(map->ids, 0xFF, (map->mask + 1) * sizeof(uint32_t));
+}
+
+static inline size_t mesh_lod_map_home(const mesh_lod_map* map, uint64_t key) {
+    return (size_t)((key * 0x9E3779B97F4A7C15ull) >> map->shift);
+}
+
+// Returns the id of `key`, inserting it as `next_id` when it is new
+static uint32_t mesh_lod_map_insert(mesh_lod_map* map, uint64_t key, uint32_t next_id) {
+    size_t i = mesh_lod_map_home(map, key);
+    while (map->ids[i] != MESH_LOD_EMPTY) {
+        if (map->keys[i] == key) return map->ids[i];
+        i = (i + 1) & map->mask;
+    }
+    map->keys[i] = key;
+    map->ids[i] = next_id;
+    return next_id;
+}
+
+// Working arrays for one level, sized for the source mesh
+typedef struct mesh_lod_scratch {
+    mesh_lod_map cells;   // grid cell -> cluster
+    mesh_lod_map faces;   // sorted corner hash -> triangle, for duplicates
+    mesh_lod_map pairs;   // vertex pair -> edge
+    uint32_t* cluster;    // per source vertex
+    uint32_t* members;    // per cluster
+    float* x;             // per cluster, sums then means
+    float* y;
+    float* z;
+    uint32_t* tri_map;    // per source triangle, MESH_TRI_NONE when dropped
+    uint32_t* tris;
+    uint32_t* edges;
+    uint32_t* edge_tris;
+    uint8_t* had_tris;    // per edge, a source edge under it had triangles
+} mesh_lod_scratch;
+
+static void mesh_lod_scratch_free(mesh_lod_scratch* s) {
+    mesh_lod_map_free(&s->cells);
+    mesh_lod_map_free(&s->faces);
+    mesh_lod_map_free(&s->pairs);
+    free(s->cluster);
+    free(s->members);
+    free(s->x);
+    free(s->y);
+    free(s->z);
+    free(s->tri_map);
+    free(s->tris);
+    free(s->edges);
+    free(s->edge_tris);
+    free(s->had_tris);
+}
+
+static bool mesh_lod_scratch_init(mesh_lod_scratch* s, const mesh* m) {
+    memset(s, 0, sizeof(*s));
+    size_t v = m->vertex_count ? m->vertex_count : 1;
+    size_t t = m->tri_count ? m->tri_count : 1;
+    size_t e = m->edge_count ? m->edge_count : 1;
+
+    bool maps = mesh_lod_map_init(&s->cells, v) & mesh_lod_map_init(&s->faces, t) & mesh_lod_map_init(&s->pairs, e);
+    s->cluster = malloc(v * sizeof(uint32_t));
+    s->members = malloc(v * sizeof(uint32_t));
+    s->x = malloc(v * sizeof(float));
+    s->y = malloc(v * sizeof(float));
+    s->z = malloc(v * sizeof(float));
+    s->tri_map = malloc(t * sizeof(uint32_t));
+    s->tris = malloc(t * 3 * sizeof(uint32_t));
+    s->edges = malloc(e * 2 * sizeof(uint32_t));
+    s->edge_tris = malloc(e * 2 * sizeof(uint32_t));
+    s->had_tris = malloc(e);
+    if (!maps || !s->cluster || !s->members || !s->x || !s->y || !s->z || !s->tri_map || !s->tris ||
+        !s->edges || !s->edge_tris || !s->had_tris) {
+        mesh_lod_scratch_free(s);
+        return false;
+    }
+    return true;
+}
+
+// Merges the vertices of `m` per grid cell. Returns the cluster count.
+static uint32_t mesh_lod_cluster(mesh_lod_scratch* s, const mesh* m, const float* lo, float extent, int grid) {
+    float inv = extent > 0.0f ? (float)grid / extent : 0.0f;
+    uint32_t count = 0;
+
+    mesh_lod_map_clear(&s->cells);
+    for (uint32_t i = 0; i < m->vertex_count; i++) {
+        int cx = (int)((m->x[i] - lo[0]) * inv);
+        int cy = (int)((m->y[i] - lo[1]) * inv);
+        int cz = (int)((m->z[i] - lo[2]) * inv);
+        // The far faces of the box belong to the last cell
+        if (cx >= grid) cx = grid - 1;
+        if (cy >= grid) cy = grid - 1;
+        if (cz >= grid) cz = grid - 1;
+        uint64_t key = ((uint64_t)cx * (uint64_t)grid + (uint64_t)cy) * (uint64_t)grid + (uint64_t)cz;
+
+        uint32_t id = mesh_lod_map_insert(&s->cells, key, count);
+        if (id == count) {
+            s->x[id] = 0.0f;
+            s->y[id] = 0.0f;
+            s->z[id] = 0.0f;
+            s->members[id] = 0;
+            count++;
+        }
+        s->cluster[i] = id;
+        s->x[id] += m->x[i];
+        s->y[id] += m->y[i];
+        s->z[id] += m->z[i];
+        s->members[id]++;
+    }
+    for (uint32_t c = 0; c < count; c++) {
+        float inv_members = 1.0f / (float)s->members[c];
+        s->x[c] *= inv_members;
+        s->y[c] *= inv_members;
+        s->z[c] *= inv_members;
+    }
+    return count;
+}
+
+static inline void mesh_lod_sort3(uint32_t* v) {
+    uint32_t t;
+    if (v[0] > v[1]) { t = v[0]; v[0] = v[1]; v[1] = t; }
+    if (v[1] > v[2]) { t = v[1]; v[1] = v[2]; v[2] = t; }
+    if (v[0] > v[1]) { t = v[0]; v[0] = v[1]; v[1] = t; }
+}
+
+// Remaps the source triangles onto clusters, dropping collapsed ones and
+// folding duplicates (in either winding) into the first. Returns the count.
+static uint32_t mesh_lod_triangles(mesh_lod_scratch* s, const mesh* m) {
+    uint32_t count = 0;
+
+    mesh_lod_map_clear(&s->faces);
+    for (uint32_t t = 0; t < m->tri_count; t++) {
+        const uint32_t* src = m->tris + (size_t)t * 3;
+        uint32_t c[3] = { s->cluster[src[0]], s->cluster[src[1]], s->cluster[src[2]] };
+        if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) {
+            s->tri_map[t] = MESH_TRI_NONE;
+            continue;
+        }
+
+        uint32_t key[3] = { c[0], c[1], c[2] };
+        mesh_lod_sort3(key);
+        uint64_t hash = ((uint64_t)key[0] * 0x9E3779B1u) ^ ((uint64_t)key[1] << 21) ^ ((uint64_t)key[2] << 42);
+
+        // Probe by hash, comparing the stored triangles' corners
+        mesh_lod_map* map = &s->faces;
+        size_t i = mesh_lod_map_home(map, hash);
+        uint32_t found = MESH_TRI_NONE;
+        while (map->ids[i] != MESH_LOD_EMPTY) {
+            if (map->keys[i] == hash) {
+                uint32_t other[3];
+                memcpy(other, s->tris + (size_t)map->ids[i] * 3, sizeof(other));
+                mesh_lod_sort3(other);
+                if (memcmp(other, key, sizeof(key)) == 0) {
+                    found = map->ids[i];
+                    break;
+                }
+            }
+            i = (i + 1) & map->mask;
+        }
+        if (found == MESH_TRI_NONE) {
+            map->keys[i] = hash;
+            map->ids[i] = count;
+            memcpy(s->tris + (size_t)count * 3, c, sizeof(c));
+            found = count++;
+        }
+        s->tri_map[t] = found;
+    }
+    return count;
+}
+
+// Remaps the source edges, each keeping up to two distinct surviving
+// triangles. Edges whose triangles all collapsed are dropped, plain line
+// edges are kept. Returns the count.
+static uint32_t mesh_lod_edges(mesh_lod_scratch* s, const mesh* m) {
+    uint32_t count = 0;
+
+    mesh_lod_map_clear(&s->pairs);
+    for (uint32_t e = 0; e < m->edge_count; e++) {
+        uint32_t a = s->cluster[m->edges[e * 2]];
+        uint32_t b = s->cluster[m->edges[e * 2 + 1]];
+        if (a == b) continue;
+        if (a > b) {
+            uint32_t tmp = a;
+            a = b;
+            b = tmp;
+        }
+
+        uint32_t id = mesh_lod_map_insert(&s->pairs, ((uint64_t)a << 32) | b, count);
+        uint32_t* adjacent = s->edge_tris + (size_t)id * 2;
+        if (id == count) {
+            s->edges[id * 2] = a;
+            s->edges[id * 2 + 1] = b;
+            adjacent[0] = MESH_TRI_NONE;
+            adjacent[1] = MESH_TRI_NONE;
+            s->had_tris[id] = 0;
+            count++;
+        }
+
+        for (int k = 0; k < 2; k++) {
+            uint32_t src = m->edge_tris[e * 2 + k];
+            if (src == MESH_TRI_NONE) continue;
+            s->had_tris[id] = 1;
+            uint32_t t = s->tri_map[src];
+            if (t == MESH_TRI_NONE || t == adjacent[0] || t == adjacent[1]) continue;
+            if (adjacent[0] == MESH_TRI_NONE) adjacent[0] = t;
+            else if (adjacent[1] == MESH_TRI_NONE) adjacent[1] = t;
+        }
+    }
+
+    uint32_t kept = 0;
+    for (uint32_t e = 0; e < count; e++) {
+        if (s->had_tris[e] && s->edge_tris[e * 2] == MESH_TRI_NONE) continue;
+        memmove(s->edges + (size_t)kept * 2, s->edges + (size_t)e * 2, 2 * sizeof(uint32_t));
+        memmove(s->edge_tris + (size_t)kept * 2, s->edge_tris + (size_t)e * 2, 2 * sizeof(uint32_t));
+        kept++;
+    }
+    return kept;
+}
+
+void mesh_lod_init(mesh_lod* lod, const mesh* m) {
+    memset(lod, 0, sizeof(*lod));
+    lod->levels[0] = m;
+    lod->level_count = 1;
+}
+
+void mesh_lod_build(mesh_lod* lod, const mesh* m) {
+    mesh_lod_init(lod, m);
+    if (m->vertex_count == 0) return;
+
+    float lo[3] = { m->x[0], m->y[0], m->z[0] };
+    float hi[3] = { m->x[0], m->y[0], m->z[0] };
+    for (uint32_t i = 0; i < m->vertex_count; i++) {
+        const float p[3] = { m->x[i], m->y[i], m->z[i] };
+        for (int k = 0; k < 3; k++) {
+            if (p[k] < lo[k]) lo[k] = p[k];
+            if (p[k] > hi[k]) hi[k] = p[k];
+        }
+    }
+    for (int k = 0; k < 3; k++) {
+        if (hi[k] - lo[k] > lod->extent) lod->extent = hi[k] - lo[k];
+    }
+
+    mesh_lod_scratch s;
+    if (!mesh_lod_scratch_init(&s, m)) return;
+
+    uint32_t previous = m->vertex_count;
+    for (int grid = MESH_LOD_FINEST_GRID; grid >= MESH_LOD_COARSEST_GRID && lod->level_count < MESH_LOD_MAX_LEVELS;
+         grid /= 2) {
+        uint32_t vertices = mesh_lod_cluster(&s, m, lo, lod->extent, grid);
+        if (vertices > previous * MESH_LOD_MIN_SAVING) continue;
+
+        uint32_t tris = mesh_lod_triangles(&s, m);
+        uint32_t edges = mesh_lod_edges(&s, m);
+        mesh* level = &lod->built[lod->level_count];
+        if (!mesh_assemble(level, s.x, s.y, s.z, vertices, s.edges, s.edge_tris, edges, s.tris, tris)) break;
+
+        lod->levels[lod->level_count] = level;
+        lod->grid[lod->level_count] = grid;
+        lod->level_count++;
+        previous = vertices;
+    }
+    mesh_lod_scratch_free(&s);
+}
+
+void mesh_lod_free(mesh_lod* lod) {
+    for (int i = 1; i < lod->level_count; i++) mesh_free(&lod->built[i]);
+    lod->level_count = lod->levels[0] ? 1 : 0;
+}
+
+int mesh_lod_select(const mesh_lod* lod, float scale, float distance) {
+    if (distance <= 0.0f) return 0;
+    float cells_per_unit = scale / distance;
+
+    for (int i = lod->level_count - 1; i > 0; i--) {
+        float cell = lod->extent / (float)lod->grid[i] * cells_per_unit;
+        if (cell <= MESH_LOD_CELL_FRACTION) return i;
+    }
+    return 0;
+}
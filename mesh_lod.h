@@ -0,0 +1,53 @@
+#ifndef _MESH_LOD_H_
+#define _MESH_LOD_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mesh.h"
+
+// Levels of detail by vertex clustering.
+//
+// Each coarser level snaps the source vertices onto a uniform grid over the
+// bounding box and merges every occupied grid cell into one vertex at the
+// mean of its members. Triangles that collapse are dropped and duplicates
+// merged; edges are the source edges remapped, so faces keep showing their
+// polygon outline rather than their triangulation, and each edge keeps the
+// surviving triangles next to it for culling. Building is linear in the
+// mesh size and done at load.
+//
+// Grids go from MESH_LOD_FINEST_GRID cells across the box down by halves,
+// keeping only levels that drop at least a quarter of the previous level's
+// vertices. Per frame mesh_lod_select() picks the coarsest level whose grid
+// cells still project to at most MESH_LOD_CELL_FRACTION of a terminal cell
+// at the depth of the rotation center. Parts nearer the camera may lose a
+// little detail, in exchange the work stays bounded by the screen resolution
+// once a mesh is finer than the screen can show.
+
+#define MESH_LOD_MAX_LEVELS 8
+#define MESH_LOD_FINEST_GRID 512
+#define MESH_LOD_COARSEST_GRID 8
+#define MESH_LOD_MIN_SAVING 0.75 // a level must keep at most this share of vertices
+#define MESH_LOD_CELL_FRACTION 0.5f
+
+typedef struct mesh_lod {
+    const mesh* levels[MESH_LOD_MAX_LEVELS]; // [0] is the source mesh, then coarser
+    int grid[MESH_LOD_MAX_LEVELS];           // cells across the box, 0 for the source
+    int level_count;
+    float extent;                            // longest side of the bounding box
+
+    mesh built[MESH_LOD_MAX_LEVELS];
+} mesh_lod;
+
+// Just the source level, `m`, which must outlive `lod`
+void mesh_lod_init(mesh_lod* lod, const mesh* m);
+
+// Builds the coarser levels of `m`, which must outlive `lod`. A level that
+// cannot be allocated ends the chain early; the source level is always there.
+void mesh_lod_build(mesh_lod* lod, const mesh* m);
+void mesh_lod_free(mesh_lod* lod);
+
+// Level for a projection with factor scale / (z + distance), see xform_view
+int mesh_lod_select(const mesh_lod* lod, float scale, float distance);
+
+#endif /* _MESH_LOD_H_ */
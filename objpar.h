@@ -17,6 +17,13 @@
 * `#define objpar_atoi my_atoi`
 * `#define objpar_atof my_atof`
 *
+* objpar_fast.h provides a locale independent, correctly rounded pair and includes this
+* header with them. Numbers may use exponent notation (1.5e-3).
+*
+* Sizes and counts use objpar_size_t (size_t) so inputs larger than 4GB work. The input
+* string does not need to be null or newline terminated: reads past string_size are
+* treated as the end of a line, so a memory-mapped file can be passed in directly.
+*
 * For now it only supports:
 * - Geometric Vertices.
 * - Vertex Normals.
@@ -62,6 +69,18 @@ extern "C"
 #define objpar_atof (float)atof
 #endif
 
+#include <stddef.h>
+#include <string.h>
+
+typedef size_t objpar_size_t;
+
+/* Every translation unit gets its own copy, don't warn about the unused ones */
+#if defined(__GNUC__)
+#define OBJPAR_STATIC static __attribute__((unused))
+#else
+#define OBJPAR_STATIC static
+#endif
+
 #define OBJPAR_NULL(type) ((type*)0)
 
 #define OBJPAR_V_IDX 0
@@ -79,10 +98,10 @@ typedef struct objpar_data
     unsigned int* p_faces;
     
     /* Sizes */
-    unsigned int position_count;
-    unsigned int normal_count;
-    unsigned int texcoord_count;
-    unsigned int face_count;
+    objpar_size_t position_count;
+    objpar_size_t normal_count;
+    objpar_size_t texcoord_count;
+    objpar_size_t face_count;
     unsigned int position_width;
     unsigned int normal_width;
     unsigned int texcoord_width;
@@ -93,7 +112,7 @@ typedef struct objpar_data
 typedef struct objpar_mesh
 {
     void* p_vertices;
-    unsigned int vertex_count;
+    objpar_size_t vertex_count;
     unsigned int vertex_stride;
     int position_offset;
     int texcoord_offset;
@@ -101,32 +120,36 @@ typedef struct objpar_mesh
 } objpar_mesh_t;
 
 /* Declaration */
-static unsigned int objpar(const char* p_string, unsigned int string_size, void* p_buffer, struct objpar_data* p_data);
-static unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer, struct objpar_mesh* p_mesh);
-static unsigned int objpar_internal_v(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_vbuff, unsigned int vertex_width);
-static unsigned int objpar_internal_vn(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_nbuff, unsigned int normal_width);
-static unsigned int objpar_internal_vt(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_tbuff, unsigned int texcoord_width);
-static unsigned int objpar_internal_f(const char* p_string, unsigned int* p_index, unsigned int string_size, unsigned int** pp_fbuff, unsigned int face_width);
-static unsigned int objpar_internal_comment(const char* p_string, unsigned int* p_index, unsigned int string_size);
-static unsigned int objpar_internal_newline(const char* p_string, unsigned int* p_index, unsigned int string_size, unsigned int* p_space_count);
+OBJPAR_STATIC objpar_size_t objpar(const char* p_string, objpar_size_t string_size, void* p_buffer, struct objpar_data* p_data);
+OBJPAR_STATIC objpar_size_t objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer, struct objpar_mesh* p_mesh);
+OBJPAR_STATIC unsigned int objpar_internal_v(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_vbuff, unsigned int vertex_width);
+OBJPAR_STATIC unsigned int objpar_internal_vn(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_nbuff, unsigned int normal_width);
+OBJPAR_STATIC unsigned int objpar_internal_vt(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_tbuff, unsigned int texcoord_width);
+OBJPAR_STATIC unsigned int objpar_internal_f(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, unsigned int** pp_fbuff, unsigned int face_width);
+OBJPAR_STATIC unsigned int objpar_internal_comment(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size);
+OBJPAR_STATIC unsigned int objpar_internal_newline(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, unsigned int* p_space_count);
+OBJPAR_STATIC char objpar_internal_char(const char* p_string, objpar_size_t index, objpar_size_t string_size);
+OBJPAR_STATIC int objpar_internal_is_float_char(char c);
+OBJPAR_STATIC float objpar_internal_atof(const char* p_string, objpar_size_t start, objpar_size_t end, objpar_size_t string_size);
+OBJPAR_STATIC int objpar_internal_atoi(const char* p_string, objpar_size_t start, objpar_size_t end, objpar_size_t string_size);
 
 /* Definition */
-unsigned int objpar(const char* p_string, unsigned int string_size, void* p_buffer, struct objpar_data* p_data)
+objpar_size_t objpar(const char* p_string, objpar_size_t string_size, void* p_buffer, struct objpar_data* p_data)
 {
-    unsigned int index;
-    unsigned int vertex_count;
-    unsigned int normal_count;
-    unsigned int texcoord_count;
-    unsigned int face_count;
+    objpar_size_t index;
+    objpar_size_t vertex_count;
+    objpar_size_t normal_count;
+    objpar_size_t texcoord_count;
+    objpar_size_t face_count;
     unsigned int vertex_width;
     unsigned int normal_width;
     unsigned int texcoord_width;
     unsigned int face_width;
-    unsigned int vertex_buffer_size;
-    unsigned int normal_buffer_size;
-    unsigned int texcoord_buffer_size;
-    unsigned int face_buffer_size;
-    unsigned int total_buffer_size;
+    objpar_size_t vertex_buffer_size;
+    objpar_size_t normal_buffer_size;
+    objpar_size_t texcoord_buffer_size;
+    objpar_size_t face_buffer_size;
+    objpar_size_t total_buffer_size;
     unsigned int face_comp_count;
     float* p_vertices;
     float* p_normals;
@@ -252,22 +275,22 @@ unsigned int objpar(const char* p_string, unsigned int string_size, void* p_buff
     return 1;
 }
 
-unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer, struct objpar_mesh* p_mesh)
+objpar_size_t objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer, struct objpar_mesh* p_mesh)
 {
     unsigned int* p_faces;
     unsigned int offset_size;
     unsigned int stride;
-    unsigned int position_count;
-    unsigned int texcoord_count;
-    unsigned int normal_count;
+    objpar_size_t position_count;
+    objpar_size_t texcoord_count;
+    objpar_size_t normal_count;
     unsigned int position_width;
     unsigned int texcoord_width;
     unsigned int normal_width;
     unsigned int face_width;
     unsigned int component_offset;
     unsigned int vertex_component_count;
-    unsigned int vertex_count;
-    unsigned int index;
+    objpar_size_t vertex_count;
+    objpar_size_t index;
     void* p_current;
     float* p_positions;
     float* p_texcoords;
@@ -296,7 +319,7 @@ unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer,
     if (p_buffer == OBJPAR_NULL(void) ||
         p_mesh == OBJPAR_NULL(void))
     {
-        return stride * face_width * vertex_count;
+        return (objpar_size_t)stride * face_width * vertex_count;
     }
 
     component_offset = 0;
@@ -328,12 +351,12 @@ unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer,
     p_normals = p_data->p_normals;
 
     {
-        unsigned int count = vertex_count * face_width * 3;
+        objpar_size_t count = vertex_count * face_width * 3;
         for (index = 0; index < count; index += 3)
         {
             if (position_count > 0)
             {
-                unsigned int idx;
+                objpar_size_t idx;
                 unsigned int j;
                 float* p_position = (float*)p_current;
 
@@ -349,7 +372,7 @@ unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer,
             }
             if (texcoord_count > 0)
             {
-                unsigned int idx;
+                objpar_size_t idx;
                 unsigned int j;
                 float* p_texcoord = (float*)p_current;
 
@@ -364,7 +387,7 @@ unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer,
             }
             if (normal_count > 0)
             {
-                unsigned int idx;
+                objpar_size_t idx;
                 unsigned int j;
                 float* p_normal = (float*)p_current;
 
@@ -384,10 +407,10 @@ unsigned int objpar_build_mesh(const struct objpar_data* p_data, void* p_buffer,
     return 1;
 }
 
-unsigned int objpar_internal_v(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_vbuff, unsigned int vertex_width)
+unsigned int objpar_internal_v(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_vbuff, unsigned int vertex_width)
 {
-    char str[32];
-    unsigned int index;
+    objpar_size_t index;
+    objpar_size_t start;
     unsigned int comp_count;
     unsigned int str_size;
     unsigned int i;
@@ -396,8 +419,8 @@ unsigned int objpar_internal_v(const char* p_string, unsigned int* p_index, unsi
     float* p_vertex;
 
     index = *p_index;
-    c0 = p_string[index];
-    c1 = p_string[index + 1];
+    c0 = objpar_internal_char(p_string, index, string_size);
+    c1 = objpar_internal_char(p_string, index + 1, string_size);
 
     if (c0 == 'v' && c1 == ' ')
     {
@@ -417,25 +440,23 @@ unsigned int objpar_internal_v(const char* p_string, unsigned int* p_index, unsi
         {
             p_vertex[i] = 0.0f;
         }
-        c0 = p_string[index];
+        c0 = objpar_internal_char(p_string, index, string_size);
 
         while (c0 != '\n' && c0 != '\r')
         {
-            while (c0 > 0x2C && c0 < 0x3A)
-            {
-                str[str_size++] = c0;
-                c0 = p_string[++index];
-            }
-            if (str_size > 0)
+            start = index;
+            while (objpar_internal_is_float_char(c0))
+                c0 = objpar_internal_char(p_string, ++index, string_size);
+            str_size = (unsigned int)(index - start);
+            if (str_size > 0 && comp_count < vertex_width)
             {
                 float comp;
-                str[str_size] = 0;
-                comp = objpar_atof(str); /* TODO: implement custom objpar_atof */
+                comp = objpar_internal_atof(p_string, start, index, string_size);
                 p_vertex[comp_count] = comp;
             }
             comp_count += 1;
             if (c0 != '\n')
-                c0 = p_string[++index];
+                c0 = objpar_internal_char(p_string, ++index, string_size);
             str_size = 0;
         }
         *pp_vbuff = p_vertex + vertex_width;
@@ -445,10 +466,10 @@ unsigned int objpar_internal_v(const char* p_string, unsigned int* p_index, unsi
     return 0;
 }
 
-unsigned int objpar_internal_vn(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_nbuff, unsigned int normal_width)
+unsigned int objpar_internal_vn(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_nbuff, unsigned int normal_width)
 {
-    char str[32];
-    unsigned int index;
+    objpar_size_t index;
+    objpar_size_t start;
     unsigned int comp_count;
     unsigned int str_size;
     unsigned int i;
@@ -457,8 +478,8 @@ unsigned int objpar_internal_vn(const char* p_string, unsigned int* p_index, uns
     float* p_normal;
 
     index = *p_index;
-    c0 = p_string[index];
-    c1 = p_string[index + 1];
+    c0 = objpar_internal_char(p_string, index, string_size);
+    c1 = objpar_internal_char(p_string, index + 1, string_size);
 
     if (c0 == 'v' && c1 == 'n')
     {
@@ -478,25 +499,23 @@ unsigned int objpar_internal_vn(const char* p_string, unsigned int* p_index, uns
         {
             p_normal[i] = 0.0f;
         }
-        c0 = p_string[index];
+        c0 = objpar_internal_char(p_string, index, string_size);
 
         while (c0 != '\n' && c0 != '\r')
         {
-            while (c0 > 0x2C && c0 < 0x3A)
-            {
-                str[str_size++] = c0;
-                c0 = p_string[++index];
-            }
-            if (str_size > 0)
+            start = index;
+            while (objpar_internal_is_float_char(c0))
+                c0 = objpar_internal_char(p_string, ++index, string_size);
+            str_size = (unsigned int)(index - start);
+            if (str_size > 0 && comp_count < normal_width)
             {
                 float comp;
-                str[str_size] = 0;
-                comp =  objpar_atof(str); /* TODO: implement custom objpar_atof */
+                comp = objpar_internal_atof(p_string, start, index, string_size);
                 p_normal[comp_count] = comp;
             }
             comp_count += 1;
             if (c0 != '\n')
-                c0 = p_string[++index];
+                c0 = objpar_internal_char(p_string, ++index, string_size);
             str_size = 0;
         }
         *pp_nbuff = p_normal + normal_width;
@@ -506,10 +525,10 @@ unsigned int objpar_internal_vn(const char* p_string, unsigned int* p_index, uns
     return 0;
 }
 
-unsigned int objpar_internal_vt(const char* p_string, unsigned int* p_index, unsigned int string_size, float** pp_tbuff, unsigned int texcoord_width)
+unsigned int objpar_internal_vt(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, float** pp_tbuff, unsigned int texcoord_width)
 {
-    char str[32];
-    unsigned int index;
+    objpar_size_t index;
+    objpar_size_t start;
     unsigned int comp_count;
     unsigned int str_size;
     unsigned int i;
@@ -518,8 +537,8 @@ unsigned int objpar_internal_vt(const char* p_string, unsigned int* p_index, uns
     float* p_texcoord;
 
     index = *p_index;
-    c0 = p_string[index];
-    c1 = p_string[index + 1];
+    c0 = objpar_internal_char(p_string, index, string_size);
+    c1 = objpar_internal_char(p_string, index + 1, string_size);
 
     if (c0 == 'v' && c1 == 't')
     {
@@ -539,25 +558,23 @@ unsigned int objpar_internal_vt(const char* p_string, unsigned int* p_index, uns
         {
             p_texcoord[i] = 0.0f;
         }
-        c0 = p_string[index];
+        c0 = objpar_internal_char(p_string, index, string_size);
 
         while (c0 != '\n' && c0 != '\r')
         {
-            while (c0 > 0x2C && c0 < 0x3A)
-            {
-                str[str_size++] = c0;
-                c0 = p_string[++index];
-            }
-            if (str_size > 0)
+            start = index;
+            while (objpar_internal_is_float_char(c0))
+                c0 = objpar_internal_char(p_string, ++index, string_size);
+            str_size = (unsigned int)(index - start);
+            if (str_size > 0 && comp_count < texcoord_width)
             {
                 float comp;
-                str[str_size] = 0;
-                comp = objpar_atof(str); /* TODO: implement custom objpar_atof */
+                comp = objpar_internal_atof(p_string, start, index, string_size);
                 p_texcoord[comp_count] = comp;
             }
             comp_count += 1;
             if (c0 != '\n')
-                c0 = p_string[++index];
+                c0 = objpar_internal_char(p_string, ++index, string_size);
             str_size = 0;
         }
         *pp_tbuff = p_texcoord + texcoord_width;
@@ -567,10 +584,10 @@ unsigned int objpar_internal_vt(const char* p_string, unsigned int* p_index, uns
     return 0;
 }
 
-unsigned int objpar_internal_f(const char* p_string, unsigned int* p_index, unsigned int string_size, unsigned int** pp_fbuff, unsigned int face_width)
+unsigned int objpar_internal_f(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, unsigned int** pp_fbuff, unsigned int face_width)
 {
-    char str[32];
-    unsigned int index;
+    objpar_size_t index;
+    objpar_size_t start;
     unsigned int comp_count;
     unsigned int comp_offset;
     unsigned int str_size;
@@ -581,8 +598,8 @@ unsigned int objpar_internal_f(const char* p_string, unsigned int* p_index, unsi
     unsigned int* p_face;
 
     index = *p_index;
-    c0 = p_string[index];
-    c1 = p_string[index + 1];
+    c0 = objpar_internal_char(p_string, index, string_size);
+    c1 = objpar_internal_char(p_string, index + 1, string_size);
     face_comp_count = 3;
     if (c0 == 'f' && c1 == ' ')
     {
@@ -609,28 +626,26 @@ unsigned int objpar_internal_f(const char* p_string, unsigned int* p_index, unsi
             p_face[i + 2] = 0;
         }
 
-        c0 = p_string[index];
+        c0 = objpar_internal_char(p_string, index, string_size);
         while (c0 != '\n' && c0 != '\r')
         {
+            start = index;
             while (c0 > 0x2F && c0 < 0x3A)
+                c0 = objpar_internal_char(p_string, ++index, string_size);
+            str_size = (unsigned int)(index - start);
+            if (str_size > 0 && comp_count < face_width * face_comp_count)
             {
-                str[str_size++] = c0;
-                c0 = p_string[++index];
-            }
-            if (str_size > 0)
-            {
-                str[str_size] = 0;
-                p_face[comp_count] = objpar_atoi(str);
-                str_size = str_size;
+                p_face[comp_count] = objpar_internal_atoi(p_string, start, index, string_size);
             }
             comp_count += 1;
             if (c0 != '/' && comp_count % 3 != 0 && comp_count < face_width * face_comp_count)
             {
                 comp_count += 2;
-                c0 = p_string[++index];
+                if (c0 != '\n' && c0 != '\r')
+                    c0 = objpar_internal_char(p_string, ++index, string_size);
             }
             else if (c0 != '\n')
-                c0 = p_string[++index];
+                c0 = objpar_internal_char(p_string, ++index, string_size);
             str_size = 0;
         }
         *p_index = index;
@@ -640,19 +655,19 @@ unsigned int objpar_internal_f(const char* p_string, unsigned int* p_index, unsi
     return 0;
 }
 
-unsigned int objpar_internal_comment(const char* p_string, unsigned int* p_index, unsigned int string_size)
+unsigned int objpar_internal_comment(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size)
 {
-    unsigned int index;
+    objpar_size_t index;
     char c;
 
     index = *p_index;
-    c = p_string[index];
+    c = objpar_internal_char(p_string, index, string_size);
 
     if (c == '#')
     {
         while (c != '\n' && c != '\r')
         {
-            c = p_string[++index];
+            c = objpar_internal_char(p_string, ++index, string_size);
         }
         *p_index = ++index;
         return 1;
@@ -660,21 +675,21 @@ unsigned int objpar_internal_comment(const char* p_string, unsigned int* p_index
     return 0;
 }
 
-unsigned int objpar_internal_newline(const char* p_string, unsigned int* p_index, unsigned int string_size, unsigned int* p_space_count)
+unsigned int objpar_internal_newline(const char* p_string, objpar_size_t* p_index, objpar_size_t string_size, unsigned int* p_space_count)
 {
-    unsigned int index;
+    objpar_size_t index;
     unsigned int space_count;
     char c;
 
     space_count = 0;
     index = *p_index;
-    c = p_string[index];
+    c = objpar_internal_char(p_string, index, string_size);
 
     while (c != '\n' && c != '\r')
     {
         if (c == ' ' || c == '\t')
             space_count += 1;
-        c = p_string[++index];
+        c = objpar_internal_char(p_string, ++index, string_size);
     }
     *p_index = ++index;
     if (p_space_count != OBJPAR_NULL(unsigned int))
@@ -683,6 +698,52 @@ unsigned int objpar_internal_newline(const char* p_string, unsigned int* p_index
     return 1;
 }
 
+char objpar_internal_char(const char* p_string, objpar_size_t index, objpar_size_t string_size)
+{
+    /* Anything past the end of the input reads as a line break */
+    if (index >= string_size)
+        return '\n';
+    return p_string[index];
+}
+
+int objpar_internal_is_float_char(char c)
+{
+    return (c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E';
+}
+
+/* Numbers are converted where they stand: the character after the token is
+still inside the buffer and ends the conversion. Only a token running up to
+the end of the buffer (no trailing newline) is copied so it can be null
+terminated; one longer than OBJPAR_TAIL_TOKEN_MAX - 1 is rejected and the
+component left at 0 rather than converted truncated. */
+#define OBJPAR_TAIL_TOKEN_MAX 128
+
+float objpar_internal_atof(const char* p_string, objpar_size_t start, objpar_size_t end, objpar_size_t string_size)
+{
+    char str[OBJPAR_TAIL_TOKEN_MAX];
+
+    if (end < string_size)
+        return objpar_atof(p_string + start);
+    if (end - start >= sizeof(str))
+        return 0.0f;
+    memcpy(str, p_string + start, end - start);
+    str[end - start] = 0;
+    return objpar_atof(str);
+}
+
+int objpar_internal_atoi(const char* p_string, objpar_size_t start, objpar_size_t end, objpar_size_t string_size)
+{
+    char str[OBJPAR_TAIL_TOKEN_MAX];
+
+    if (end < string_size)
+        return objpar_atoi(p_string + start);
+    if (end - start >= sizeof(str))
+        return 0;
+    memcpy(str, p_string + start, end - start);
+    str[end - start] = 0;
+    return objpar_atoi(str);
+}
+
 #if __cplusplus
 }
 #endif
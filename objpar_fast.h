@@ -0,0 +1,244 @@
+/**
+* objpar_fast
+* ===========
+*
+* Locale independent number conversion for objpar. Include this header instead of
+* objpar.h; it plugs objpar_fast_atof and objpar_fast_atoi in through the
+* objpar_atof/objpar_atoi macros.
+*
+* objpar_fast_atof accumulates up to 19 significant digits into an integer and scales
+* it with an exact power of ten in double precision (Clinger's fast path). The double
+* is correctly rounded, and rounding it again to float can only go wrong when it lands
+* exactly on a float midpoint, which is detected. Those midpoints, mantissas longer than
+* 19 digits and exponents outside [-22, 22] fall back to strtof, run with the calling
+* thread switched to the C locale so a ',' decimal separator can't cut the number short.
+* Exponent notation (1.5e-3, 2E+4) is supported.
+*/
+
+#ifndef _OBJPAR_FAST_H_
+#define _OBJPAR_FAST_H_
+
+#include <locale.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if __cplusplus
+extern "C"
+{
+#endif
+
+static const double objpar_fast_pow10[23] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* True if rounding d to float would have to break a tie. d must be a normal float value. */
+static int objpar_fast_is_midpoint(double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    /* A double keeps 29 more fraction bits than a float */
+    return (bits & 0x1FFFFFFFull) == 0x10000000ull;
+}
+
+/* The C locale, created once and shared by all threads. (locale_t)0 if it can't be created. */
+static locale_t objpar_fast_c_locale(void)
+{
+    static locale_t shared;
+    locale_t loc;
+    locale_t created;
+
+    loc = __atomic_load_n(&shared, __ATOMIC_ACQUIRE);
+    if (loc)
+        return loc;
+
+    created = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+    if (!created)
+        return (locale_t)0;
+    if (!__atomic_compare_exchange_n(&shared, &loc, created, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        /* Another thread won the race */
+        freelocale(created);
+        return loc;
+    }
+    return created;
+}
+
+static float objpar_fast_strtof_c(const char* p_str)
+{
+    locale_t c_locale;
+    locale_t previous;
+    float value;
+
+    c_locale = objpar_fast_c_locale();
+    if (!c_locale)
+        return strtof(p_str, NULL);
+
+    previous = uselocale(c_locale);
+    value = strtof(p_str, NULL);
+    uselocale(previous);
+    return value;
+}
+
+static float objpar_fast_atof(const char* p_str)
+{
+    const char* p;
+    uint64_t mantissa;
+    int digits;
+    int exp10;
+    int truncated;
+    int negative;
+    int any;
+
+    p = p_str;
+    mantissa = 0;
+    digits = 0;
+    exp10 = 0;
+    truncated = 0;
+    negative = 0;
+    any = 0;
+
+    if (*p == '-' || *p == '+')
+    {
+        negative = (*p == '-');
+        p++;
+    }
+
+    /* Integer part, leading zeros are not significant */
+    while (*p == '0')
+    {
+        p++;
+        any = 1;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        if (digits < 19)
+        {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits++;
+        }
+        else
+        {
+            exp10++;
+            truncated |= (*p != '0');
+        }
+        p++;
+        any = 1;
+    }
+
+    /* Fraction */
+    if (*p == '.')
+    {
+        p++;
+        if (digits == 0)
+        {
+            while (*p == '0')
+            {
+                exp10--;
+                p++;
+                any = 1;
+            }
+        }
+        while (*p >= '0' && *p <= '9')
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+                digits++;
+                exp10--;
+            }
+            else
+            {
+                truncated |= (*p != '0');
+            }
+            p++;
+            any = 1;
+        }
+    }
+
+    if (!any)
+        return 0.0f;
+
+    /* Exponent, ignored unless at least one digit follows */
+    if (*p == 'e' || *p == 'E')
+    {
+        const char* q;
+        int exp_negative;
+        int exp_value;
+
+        q = p + 1;
+        exp_negative = 0;
+        exp_value = 0;
+        if (*q == '-' || *q == '+')
+        {
+            exp_negative = (*q == '-');
+            q++;
+        }
+        if (*q >= '0' && *q <= '9')
+        {
+            while (*q >= '0' && *q <= '9')
+            {
+                if (exp_value < 100000)
+                    exp_value = exp_value * 10 + (*q - '0');
+                q++;
+            }
+            exp10 += exp_negative ? -exp_value : exp_value;
+        }
+    }
+
+    if (mantissa == 0)
+        return negative ? -0.0f : 0.0f;
+
+    if (!truncated && mantissa <= (1ull << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+        double d;
+
+        /* Both operands are exact, so d is the correctly rounded double */
+        d = (double)mantissa;
+        if (exp10 < 0)
+            d /= objpar_fast_pow10[-exp10];
+        else
+            d *= objpar_fast_pow10[exp10];
+
+        if (!objpar_fast_is_midpoint(d))
+            return negative ? -(float)d : (float)d;
+    }
+
+    /* Rare hard case */
+    return objpar_fast_strtof_c(p_str);
+}
+
+static int objpar_fast_atoi(const char* p_str)
+{
+    const char* p;
+    unsigned int value;
+    int negative;
+
+    p = p_str;
+    value = 0;
+    negative = 0;
+
+    if (*p == '-' || *p == '+')
+    {
+        negative = (*p == '-');
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+    {
+        value = value * 10 + (unsigned int)(*p - '0');
+        p++;
+    }
+    return negative ? -(int)value : (int)value;
+}
+
+#if __cplusplus
+}
+#endif
+
+#define objpar_atof objpar_fast_atof
+#define objpar_atoi objpar_fast_atoi
+#include "objpar.h"
+
+#endif /* _OBJPAR_FAST_H_ */
@@ -0,0 +1,245 @@
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "objpar_mt.h"
+
+static void objpar_mt_count(objpar_mt_chunk* c) {
+    const char* p_string = c->p_string;
+    objpar_size_t string_size = c->size;
+    objpar_size_t index = 0;
+
+    while (index < string_size) {
+        unsigned int count;
+
+        if ((count = objpar_internal_v(p_string, &index, string_size, OBJPAR_NULL(float*), 0))) {
+            c->vertex_count += 1;
+            c->vertex_width = count;
+        } else if ((count = objpar_internal_vn(p_string, &index, string_size, OBJPAR_NULL(float*), 0))) {
+            c->normal_count += 1;
+            c->normal_width = count;
+        } else if ((count = objpar_internal_vt(p_string, &index, string_size, OBJPAR_NULL(float*), 0))) {
+            c->texcoord_count += 1;
+            c->texcoord_width = count;
+        } else if ((count = objpar_internal_f(p_string, &index, string_size, OBJPAR_NULL(unsigned int*), 0))) {
+            c->face_count += 1;
+            c->face_width = count;
+        } else if (objpar_internal_comment(p_string, &index, string_size));
+        else objpar_internal_newline(p_string, &index, string_size, OBJPAR_NULL(unsigned int));
+    }
+}
+
+static void objpar_mt_fill_chunk(objpar_mt_chunk* c) {
+    const char* p_string = c->p_string;
+    objpar_size_t string_size = c->size;
+    objpar_size_t index = 0;
+    float* p_vertices = c->p_vertices;
+    float* p_normals = c->p_normals;
+    float* p_texcoords = c->p_texcoords;
+    unsigned int* p_faces = c->p_faces;
+
+    while (index < string_size) {
+        if (objpar_internal_v(p_string, &index, string_size, &p_vertices, c->fill_vertex_width));
+        else if (objpar_internal_vn(p_string, &index, string_size, &p_normals, c->fill_normal_width));
+        else if (objpar_internal_vt(p_string, &index, string_size, &p_texcoords, c->fill_texcoord_width));
+        else if (objpar_internal_f(p_string, &index, string_size, &p_faces, c->fill_face_width));
+        else if (objpar_internal_comment(p_string, &index, string_size));
+        else objpar_internal_newline(p_string, &index, string_size, OBJPAR_NULL(unsigned int));
+    }
+}
+
+static void* objpar_mt_worker(void* arg) {
+    objpar_mt_chunk* c = (objpar_mt_chunk*)arg;
+    if (c->fill) objpar_mt_fill_chunk(c);
+    else objpar_mt_count(c);
+    return NULL;
+}
+
+// Runs every chunk, chunk 0 on the calling thread
+static void objpar_mt_run(objpar_mt_chunk* chunks, int chunk_count) {
+    pthread_t threads[OBJPAR_MT_MAX_THREADS];
+    int started[OBJPAR_MT_MAX_THREADS];
+
+    for (int i = 1; i < chunk_count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, objpar_mt_worker, &chunks[i]) == 0;
+        if (!started[i]) objpar_mt_worker(&chunks[i]);
+    }
+    objpar_mt_worker(&chunks[0]);
+    for (int i = 1; i < chunk_count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+// Splits the input after line breaks into at most `wanted` chunks
+static int objpar_mt_split(const char* p_string, objpar_size_t string_size, objpar_mt_chunk* chunks, int wanted) {
+    objpar_size_t start = 0;
+    int count = 0;
+
+    for (int i = 1; i <= wanted && start < string_size; i++) {
+        objpar_size_t end = string_size;
+        if (i < wanted) {
+            end = string_size / (objpar_size_t)wanted * (objpar_size_t)i;
+            if (end < start) end = start;
+            const char* nl = memchr(p_string + end, '\n', string_size - end);
+            end = nl ? (objpar_size_t)(nl - p_string) + 1 : string_size;
+        }
+        if (end <= start) continue;
+
+        memset(&chunks[count], 0, sizeof(chunks[count]));
+        chunks[count].p_string = p_string + start;
+        chunks[count].size = end - start;
+        count++;
+        start = end;
+    }
+    return count;
+}
+
+objpar_size_t objpar_mt_begin(objpar_mt_context* ctx, const char* p_string, objpar_size_t string_size, int thread_count) {
+    objpar_mt_chunk* chunks = ctx->chunks;
+
+    ctx->chunk_count = 0;
+
+    if (thread_count <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (int)online : 1;
+    }
+    if ((objpar_size_t)thread_count > string_size / OBJPAR_MT_MIN_CHUNK) {
+        thread_count = (int)(string_size / OBJPAR_MT_MIN_CHUNK);
+    }
+    if (thread_count > OBJPAR_MT_MAX_THREADS) thread_count = OBJPAR_MT_MAX_THREADS;
+    // A single chunk runs on the calling thread, still counted only once
+    if (thread_count < 1) thread_count = 1;
+
+    int chunk_count = objpar_mt_split(p_string, string_size, chunks, thread_count);
+    ctx->chunk_count = chunk_count;
+
+    // Count pass
+    objpar_mt_run(chunks, chunk_count);
+
+    objpar_size_t vertex_count = 0;
+    objpar_size_t normal_count = 0;
+    objpar_size_t texcoord_count = 0;
+    objpar_size_t face_count = 0;
+    unsigned int vertex_width = 0;
+    unsigned int normal_width = 0;
+    unsigned int texcoord_width = 0;
+    unsigned int face_width = 0;
+    const unsigned int face_comp_count = 3;
+
+    // Widths follow objpar: the last record of each kind wins
+    for (int i = 0; i < chunk_count; i++) {
+        vertex_count += chunks[i].vertex_count;
+        normal_count += chunks[i].normal_count;
+        texcoord_count += chunks[i].texcoord_count;
+        face_count += chunks[i].face_count;
+        if (chunks[i].vertex_count) vertex_width = chunks[i].vertex_width;
+        if (chunks[i].normal_count) normal_width = chunks[i].normal_width;
+        if (chunks[i].texcoord_count) texcoord_width = chunks[i].texcoord_width;
+        if (chunks[i].face_count) face_width = chunks[i].face_width;
+    }
+
+    objpar_size_t vertex_buffer_size = (sizeof(float) * vertex_width) * vertex_count;
+    objpar_size_t normal_buffer_size = (sizeof(float) * normal_width) * normal_count;
+    objpar_size_t texcoord_buffer_size = (sizeof(float) * texcoord_width) * texcoord_count;
+    objpar_size_t face_buffer_size = ((sizeof(unsigned int) * face_comp_count) * face_width) * face_count;
+    objpar_size_t total_buffer_size = vertex_buffer_size + normal_buffer_size + texcoord_buffer_size + face_buffer_size;
+
+    ctx->vertex_count = vertex_count;
+    ctx->normal_count = normal_count;
+    ctx->texcoord_count = texcoord_count;
+    ctx->face_count = face_count;
+    ctx->vertex_width = vertex_width;
+    ctx->normal_width = normal_width;
+    ctx->texcoord_width = texcoord_width;
+    ctx->face_width = face_width;
+    ctx->buffer_size = total_buffer_size;
+    return total_buffer_size;
+}
+
+objpar_size_t objpar_mt_fill(objpar_mt_context* ctx, void* p_buffer, struct objpar_data* p_data) {
+    if (p_buffer == OBJPAR_NULL(void) || p_data == OBJPAR_NULL(void) || ctx->buffer_size == 0) {
+        return 0;
+    }
+    objpar_mt_chunk* chunks = ctx->chunks;
+    const int chunk_count = ctx->chunk_count;
+    const objpar_size_t vertex_count = ctx->vertex_count;
+    const objpar_size_t normal_count = ctx->normal_count;
+    const objpar_size_t texcoord_count = ctx->texcoord_count;
+    const objpar_size_t face_count = ctx->face_count;
+    const unsigned int vertex_width = ctx->vertex_width;
+    const unsigned int normal_width = ctx->normal_width;
+    const unsigned int texcoord_width = ctx->texcoord_width;
+    const unsigned int face_width = ctx->face_width;
+    const unsigned int face_comp_count = 3;
+
+    // Same layout as objpar()
+    objpar_size_t vertex_buffer_size = (sizeof(float) * vertex_width) * vertex_count;
+    objpar_size_t normal_buffer_size = (sizeof(float) * normal_width) * normal_count;
+    objpar_size_t texcoord_buffer_size = (sizeof(float) * texcoord_width) * texcoord_count;
+    char* p_curr = (char*)p_buffer;
+    float* p_vertices = OBJPAR_NULL(float);
+    float* p_normals = OBJPAR_NULL(float);
+    float* p_texcoords = OBJPAR_NULL(float);
+    unsigned int* p_faces = OBJPAR_NULL(unsigned int);
+    if (vertex_count > 0) {
+        p_vertices = (float*)p_curr;
+        p_curr += vertex_buffer_size;
+    }
+    if (normal_count > 0) {
+        p_normals = (float*)p_curr;
+        p_curr += normal_buffer_size;
+    }
+    if (texcoord_count > 0) {
+        p_texcoords = (float*)p_curr;
+        p_curr += texcoord_buffer_size;
+    }
+    if (face_count > 0) {
+        p_faces = (unsigned int*)p_curr;
+    }
+
+    p_data->p_positions = p_vertices;
+    p_data->p_normals = p_normals;
+    p_data->p_texcoords = p_texcoords;
+    p_data->p_faces = p_faces;
+    p_data->position_count = vertex_count;
+    p_data->normal_count = normal_count;
+    p_data->texcoord_count = texcoord_count;
+    p_data->face_count = face_count;
+    p_data->position_width = vertex_width;
+    p_data->normal_width = normal_width;
+    p_data->texcoord_width = texcoord_width;
+    p_data->face_width = face_width;
+
+    // Prefix sum: each chunk starts writing after the records of the chunks before it
+    objpar_size_t v_offset = 0;
+    objpar_size_t n_offset = 0;
+    objpar_size_t t_offset = 0;
+    objpar_size_t f_offset = 0;
+    for (int i = 0; i < chunk_count; i++) {
+        objpar_mt_chunk* c = &chunks[i];
+        c->fill = 1;
+        c->fill_vertex_width = vertex_width;
+        c->fill_normal_width = normal_width;
+        c->fill_texcoord_width = texcoord_width;
+        c->fill_face_width = face_width;
+        c->p_vertices = p_vertices ? p_vertices + v_offset * vertex_width : OBJPAR_NULL(float);
+        c->p_normals = p_normals ? p_normals + n_offset * normal_width : OBJPAR_NULL(float);
+        c->p_texcoords = p_texcoords ? p_texcoords + t_offset * texcoord_width : OBJPAR_NULL(float);
+        c->p_faces = p_faces ? p_faces + f_offset * face_width * face_comp_count : OBJPAR_NULL(unsigned int);
+        v_offset += c->vertex_count;
+        n_offset += c->normal_count;
+        t_offset += c->texcoord_count;
+        f_offset += c->face_count;
+    }
+
+    // Fill pass
+    objpar_mt_run(chunks, chunk_count);
+    return 1;
+}
+
+objpar_size_t objpar_mt(const char* p_string, objpar_size_t string_size, void* p_buffer, struct objpar_data* p_data, int thread_count) {
+    objpar_mt_context ctx;
+    objpar_size_t size = objpar_mt_begin(&ctx, p_string, string_size, thread_count);
+    if (p_buffer == OBJPAR_NULL(void) || p_data == OBJPAR_NULL(void)) return size;
+    return objpar_mt_fill(&ctx, p_buffer, p_data);
+}
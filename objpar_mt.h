@@ -0,0 +1,83 @@
+#ifndef _OBJPAR_MT_H_
+#define _OBJPAR_MT_H_
+
+#include "objpar_fast.h"
+
+// Multithreaded objpar.
+//
+// The input is split at line boundaries into one chunk per thread. Each
+// thread counts the v/vn/vt/f records in its chunk, a prefix sum over the
+// counts gives every chunk its output offsets, and the threads then fill the
+// position, normal, texcoord and face arrays concurrently. The buffer layout
+// and the resulting objpar_data are identical to objpar().
+//
+// objpar_mt_begin() runs the count pass and keeps the chunk table and counts
+// in a context, so objpar_mt_fill() only has to do the prefix sum and the
+// fill pass: two passes over the input in all.
+
+// Inputs smaller than this per thread are not worth splitting
+#ifndef OBJPAR_MT_MIN_CHUNK
+#define OBJPAR_MT_MIN_CHUNK (1u << 20)
+#endif
+
+#define OBJPAR_MT_MAX_THREADS 64
+
+typedef struct objpar_mt_chunk {
+    const char* p_string;
+    objpar_size_t size;
+    int fill; // 0 = count pass, 1 = fill pass
+
+    // Count pass results
+    objpar_size_t vertex_count;
+    objpar_size_t normal_count;
+    objpar_size_t texcoord_count;
+    objpar_size_t face_count;
+    unsigned int vertex_width;
+    unsigned int normal_width;
+    unsigned int texcoord_width;
+    unsigned int face_width;
+
+    // Fill pass inputs: where this chunk's records start
+    float* p_vertices;
+    float* p_normals;
+    float* p_texcoords;
+    unsigned int* p_faces;
+    unsigned int fill_vertex_width;
+    unsigned int fill_normal_width;
+    unsigned int fill_texcoord_width;
+    unsigned int fill_face_width;
+} objpar_mt_chunk;
+
+typedef struct objpar_mt_context {
+    objpar_mt_chunk chunks[OBJPAR_MT_MAX_THREADS];
+    int chunk_count;
+
+    // Totals of the count pass
+    objpar_size_t vertex_count;
+    objpar_size_t normal_count;
+    objpar_size_t texcoord_count;
+    objpar_size_t face_count;
+    unsigned int vertex_width;
+    unsigned int normal_width;
+    unsigned int texcoord_width;
+    unsigned int face_width;
+    objpar_size_t buffer_size;
+} objpar_mt_context;
+
+// Splits the input and counts its records, on the calling thread alone when
+// it is too small to be worth splitting. Returns the required buffer size,
+// 0 if there is nothing to parse. `p_string` must stay valid until the fill.
+objpar_size_t objpar_mt_begin(objpar_mt_context* ctx, const char* p_string, objpar_size_t string_size, int thread_count);
+
+// Parses into `p_buffer` of at least the size objpar_mt_begin() returned.
+// Returns 1 on success and 0 on failure.
+objpar_size_t objpar_mt_fill(objpar_mt_context* ctx, void* p_buffer, struct objpar_data* p_data);
+
+// Same contract as objpar(): returns the required buffer size when p_buffer
+// or p_data is NULL, 1 on success and 0 on failure. thread_count <= 0 uses
+// every online core.
+objpar_size_t objpar_mt(const char* p_string, objpar_size_t string_size, void* p_buffer, struct objpar_data* p_data, int thread_count);
+
+#define objpar_mt_get_size(string, string_size, thread_count) objpar_mt((const char*)string, string_size, NULL, NULL, thread_count)
+
+#endif /* _OBJPAR_MT_H_ */
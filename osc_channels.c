@@ -0,0 +1,95 @@
+#include <string.h>
+
+#include "osc_channels.h"
+
+static uint32_t osc_channel_hash(const char* address, int orbit) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < sizeof(((osc_event*)0)->address) && address[i]; i++) {
+        h = (h ^ (uint8_t)address[i]) * 16777619u;
+    }
+    uint32_t o = (uint32_t)orbit;
+    for (int i = 0; i < 4; i++, o >>= 8) h = (h ^ (o & 0xFF)) * 16777619u;
+    return h;
+}
+
+// When the event took effect: its bundle due time, else its arrival
+static inline uint64_t osc_channel_event_ns(const osc_event* ev) {
+    return ev->due_ns ? ev->due_ns : ev->recv_ns;
+}
+
+void osc_channels_init(osc_channels* t) {
+    memset(t->slots, 0xFF, sizeof(t->slots));
+    t->count = 0;
+    t->rejected = 0;
+}
+
+// Slot holding the pair, or the empty slot where it would go
+static uint32_t osc_channels_probe(const osc_channels* t, const char* address, int orbit, uint32_t hash) {
+    uint32_t slot = hash & (OSC_CHANNEL_SLOTS - 1);
+    while (1) {
+        int32_t id = t->slots[slot];
+        if (id < 0) return slot;
+        const osc_channel* c = &t->channels[id];
+        if (c->hash == hash && c->orbit == orbit && strncmp(c->address, address, sizeof(c->address)) == 0) {
+            return slot;
+        }
+        slot = (slot + 1) & (OSC_CHANNEL_SLOTS - 1);
+    }
+}
+
+osc_channel* osc_channels_find(osc_channels* t, const char* address, int orbit) {
+    uint32_t slot = osc_channels_probe(t, address, orbit, osc_channel_hash(address, orbit));
+    int32_t id = t->slots[slot];
+    return id < 0 ? NULL : &t->channels[id];
+}
+
+osc_channel* osc_channels_record(osc_channels* t, const osc_event* ev) {
+    uint32_t hash = osc_channel_hash(ev->address, ev->orbit);
+    uint32_t slot = osc_channels_probe(t, ev->address, ev->orbit, hash);
+    osc_channel* c;
+
+    if (t->slots[slot] >= 0) {
+        c = &t->channels[t->slots[slot]];
+    } else {
+        if (t->count >= OSC_CHANNEL_MAX) {
+            t->rejected++;
+            return NULL;
+        }
+        t->slots[slot] = (int32_t)t->count;
+        c = &t->channels[t->count++];
+        memcpy(c->address, ev->address, sizeof(c->address));
+        c->address[sizeof(c->address) - 1] = '\0';
+        c->orbit = ev->orbit;
+        c->hash = hash;
+        c->head = 0;
+        c->total = 0;
+    }
+
+    c->history[c->head & (OSC_CHANNEL_HISTORY - 1)] = *ev;
+    c->head++;
+    c->total++;
+    c->dirty = true;
+    return c;
+}
+
+uint32_t osc_channel_recent(const osc_channel* c, uint64_t now_ns, uint64_t window_ns) {
+    uint32_t kept = c->total < OSC_CHANNEL_HISTORY ? (uint32_t)c->total : OSC_CHANNEL_HISTORY;
+    uint32_t count = 0;
+    for (uint32_t i = 1; i <= kept; i++) {
+        uint64_t t = osc_channel_event_ns(&c->history[(c->head - i) & (OSC_CHANNEL_HISTORY - 1)]);
+        if (t + window_ns < now_ns) break;
+        count++;
+    }
+    return count;
+}
+
+float osc_channel_rate(const osc_channel* c, uint64_t now_ns) {
+    uint32_t kept = c->total < OSC_CHANNEL_HISTORY ? (uint32_t)c->total : OSC_CHANNEL_HISTORY;
+    if (kept < 2) return 0.0f;
+
+    // Measured up to now rather than the newest event so a silent channel
+    // decays towards zero
+    uint64_t oldest = osc_channel_event_ns(&c->history[(c->head - kept) & (OSC_CHANNEL_HISTORY - 1)]);
+    if (now_ns <= oldest) return 0.0f;
+    return (float)((double)(kept - 1) * 1e9 / (double)(now_ns - oldest));
+}
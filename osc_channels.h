@@ -0,0 +1,60 @@
+#ifndef _OSC_CHANNELS_H_
+#define _OSC_CHANNELS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "osc_decode.h"
+
+// Channel table for decoded OSC events.
+//
+// Every (address, orbit) pair gets its own channel, found through a fixed
+// open-addressing hash table with linear probing, so lookups stay O(1) at
+// any event rate and any orbit number, negative ones included. Channels
+// live in a fixed array in creation order and each keeps a ring of its most
+// recent events, which is what rates and bursts are computed from. Nothing
+// is allocated; once OSC_CHANNEL_MAX channels exist, events for new pairs are
+// counted and dropped.
+
+#define OSC_CHANNEL_SLOTS 512  // hash slots, power of two
+#define OSC_CHANNEL_MAX 384    // live channels, keeps the load factor <= 0.75
+#define OSC_CHANNEL_HISTORY 16 // events kept per channel, power of two
+
+typedef struct osc_channel {
+    char address[32];
+    int orbit;
+    uint32_t hash;
+
+    osc_event history[OSC_CHANNEL_HISTORY]; // ring, newest at head - 1
+    uint32_t head;
+    uint64_t total;   // events ever recorded
+    bool dirty;       // changed since the display last looked
+} osc_channel;
+
+typedef struct osc_channels {
+    int32_t slots[OSC_CHANNEL_SLOTS]; // channel index, -1 when empty
+    osc_channel channels[OSC_CHANNEL_MAX];
+    uint32_t count;
+    uint64_t rejected; // events dropped because the table was full
+} osc_channels;
+
+void osc_channels_init(osc_channels* t);
+
+// Appends `ev` to the ring of its channel, creating the channel on first
+// sight. Returns NULL when the table is full.
+osc_channel* osc_channels_record(osc_channels* t, const osc_event* ev);
+
+// NULL when the pair has not been seen
+osc_channel* osc_channels_find(osc_channels* t, const char* address, int orbit);
+
+static inline const osc_event* osc_channel_latest(const osc_channel* c) {
+    return &c->history[(c->head - 1) & (OSC_CHANNEL_HISTORY - 1)];
+}
+
+// Events in the ring received within `window_ns` before `now_ns`
+uint32_t osc_channel_recent(const osc_channel* c, uint64_t now_ns, uint64_t window_ns);
+
+// Events per second over the ring, 0 until there are two events
+float osc_channel_rate(const osc_channel* c, uint64_t now_ns);
+
+#endif /* _OSC_CHANNELS_H_ */
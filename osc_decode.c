@@ -0,0 +1,170 @@
+#include <arpa/inet.h>
+#include <limits.h>
+#include <string.h>
+
+#include "osc_decode.h"
+
+// Field slots a key can map to
+enum {
+    OSC_SLOT_NONE = 0, // next argument is a key
+    OSC_SLOT_SKIP,     // next argument is the value of an unknown key
+    OSC_SLOT_SOUND,
+    OSC_SLOT_N,
+    OSC_SLOT_ORBIT,
+    OSC_SLOT_CYCLE,
+    OSC_SLOT_GAIN,
+};
+
+static inline int osc_key_slot(const char* key, size_t len) {
+    switch (len) {
+        case 1:
+            if (key[0] == 's') return OSC_SLOT_SOUND;
+            if (key[0] == 'n') return OSC_SLOT_N;
+            break;
+        case 4:
+            if (key[0] == 'g' && memcmp(key, "gain", 4) == 0) return OSC_SLOT_GAIN;
+            break;
+        case 5:
+            if (key[0] == 'o' && memcmp(key, "orbit", 5) == 0) return OSC_SLOT_ORBIT;
+            if (key[0] == 'c' && memcmp(key, "cycle", 5) == 0) return OSC_SLOT_CYCLE;
+            break;
+    }
+    return OSC_SLOT_SKIP;
+}
+
+static inline void osc_copy_string(char* dst, size_t dst_size, const char* src, size_t len) {
+    if (len >= dst_size) len = dst_size - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Saturating conversion, NaN reads as 0
+static inline int osc_to_int(double v) {
+    if (v != v) return 0;
+    if (v >= (double)INT_MAX) return INT_MAX;
+    if (v <= (double)INT_MIN) return INT_MIN;
+    return (int)v;
+}
+
+bool osc_decode_message(tosc_message* msg, osc_event* ev) {
+    const char* address = tosc_getAddress(msg);
+    const char* format = tosc_getFormat(msg);
+    if (!address || !format) return false;
+
+    const char* end = msg->buffer + msg->len;
+    const char* address_end = memchr(address, '\0', (size_t)(end - address));
+    osc_copy_string(ev->address, sizeof(ev->address), address,
+                    address_end ? (size_t)(address_end - address) : 0);
+
+    memcpy(ev->sound, "???", 4);
+    ev->n = 0;
+    ev->cycle = 0.0f;
+    ev->gain = 1.0f;
+    ev->orbit = 0;
+
+    // Padding can move the marker past the end of a truncated message
+    tosc_reset(msg);
+    if (msg->marker > end) return false;
+
+    int slot = OSC_SLOT_NONE;
+    for (const char* f = format; *f != '\0'; f++) {
+        const size_t remaining = (size_t)(end - msg->marker);
+        const char* str = NULL;
+        size_t str_len = 0;
+        double num = 0.0;
+        bool is_num = false;
+
+        switch (*f) {
+            case 'i':
+                if (remaining < 4) return false;
+                num = tosc_getNextInt32(msg);
+                is_num = true;
+                break;
+            case 'f':
+                if (remaining < 4) return false;
+                num = tosc_getNextFloat(msg);
+                is_num = true;
+                break;
+            case 'd':
+                if (remaining < 8) return false;
+                num = tosc_getNextDouble(msg);
+                is_num = true;
+                break;
+            case 'h':
+                if (remaining < 8) return false;
+                num = (double)tosc_getNextInt64(msg);
+                is_num = true;
+                break;
+            case 't':
+                if (remaining < 8) return false;
+                tosc_getNextTimetag(msg);
+                break;
+            case 'c':
+            case 'r':
+            case 'm':
+                // char, RGBA color and MIDI are all 4 bytes
+                if (remaining < 4) return false;
+                tosc_getNextMidi(msg);
+                break;
+            case 's':
+            case 'S': {
+                const char* nul = memchr(msg->marker, '\0', remaining);
+                if (!nul) return false;
+                str_len = (size_t)(nul - msg->marker);
+                str = tosc_getNextString(msg);
+                if (!str) return false;
+                break;
+            }
+            case 'b': {
+                if (remaining < 4) return false;
+                int32_t size = (int32_t)ntohl(*(const uint32_t*)msg->marker);
+                if (size < 0 || (size_t)size > remaining - 4) return false;
+                const char* blob = NULL;
+                int blob_len = 0;
+                tosc_getNextBlob(msg, &blob, &blob_len);
+                break;
+            }
+            case 'T':
+                num = 1.0;
+                is_num = true;
+                break;
+            case 'F':
+                is_num = true;
+                break;
+            case 'N':
+            case 'I':
+            case '[':
+            case ']':
+                break;
+            default:
+                // Unknown tag, its size can't be known so stop here
+                return true;
+        }
+        if (msg->marker > end) return false;
+
+        if (slot == OSC_SLOT_NONE) {
+            if (str) slot = osc_key_slot(str, str_len);
+            continue;
+        }
+
+        switch (slot) {
+            case OSC_SLOT_SOUND:
+                if (str) osc_copy_string(ev->sound, sizeof(ev->sound), str, str_len);
+                break;
+            case OSC_SLOT_N:
+                if (is_num) ev->n = osc_to_int(num);
+                break;
+            case OSC_SLOT_ORBIT:
+                if (is_num) ev->orbit = osc_to_int(num);
+                break;
+            case OSC_SLOT_CYCLE:
+                if (is_num) ev->cycle = (float)num;
+                break;
+            case OSC_SLOT_GAIN:
+                if (is_num) ev->gain = (float)num;
+                break;
+        }
+        slot = OSC_SLOT_NONE;
+    }
+    return true;
+}
@@ -0,0 +1,33 @@
+#ifndef _OSC_DECODE_H_
+#define _OSC_DECODE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tinyosc.h"
+
+// Single-pass key/value decoder for /dirt/play style messages.
+//
+// Arguments are read as alternating key, value pairs. Keys are mapped to
+// field slots by a switch on length and first character, and values of any
+// numeric type are written straight into the typed event. Every OSC type tag
+// is skipped by its proper size, so unknown keys or unusual types never
+// desync the read head.
+
+typedef struct osc_event {
+    char address[32];
+    char sound[32];
+    int n;
+    float cycle;
+    float gain;
+    int orbit;
+    uint64_t recv_ns; // CLOCK_MONOTONIC time the datagram was read
+    uint64_t due_ns;  // CLOCK_MONOTONIC time to apply it, 0 = immediately
+} osc_event;
+
+// Decodes `msg` into `ev`, leaving recv_ns and due_ns untouched. Fields not
+// present in the message get their defaults. Returns false if the message
+// has no format string or its arguments run past the end of the buffer.
+bool osc_decode_message(tosc_message* msg, osc_event* ev);
+
+#endif /* _OSC_DECODE_H_ */
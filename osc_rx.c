@@ -0,0 +1,338 @@
+#define _GNU_SOURCE // recvmmsg
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+#include "osc_rx.h"
+
+// How often the blocked thread wakes up to check for shutdown
+#define OSC_RX_POLL_MS 100
+
+// Seconds between the NTP epoch (1900) and the Unix epoch (1970)
+#define OSC_NTP_UNIX_OFFSET 2208988800ull
+
+typedef struct osc_rx_arena {
+    _Alignas(OSC_CACHE_LINE) char packets[OSC_RX_BATCH][OSC_PACKET_SIZE];
+#ifdef __linux__
+    struct mmsghdr msgs[OSC_RX_BATCH];
+#endif
+    struct iovec iov[OSC_RX_BATCH];
+} osc_rx_arena;
+
+static bool osc_queue_push(osc_receiver* rx, const osc_event* ev) {
+    osc_queue* q = &rx->queue;
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    if (head - tail >= OSC_QUEUE_SIZE) {
+        atomic_fetch_add_explicit(&rx->dropped, 1, memory_order_relaxed);
+        return false;
+    }
+    q->events[head & (OSC_QUEUE_SIZE - 1)] = *ev;
+    atomic_store_explicit(&q->head, head + 1, memory_order_release);
+    return true;
+}
+
+static void osc_rx_notify(osc_receiver* rx) {
+    if (rx->wake_fd < 0) return;
+    uint64_t one = 1;
+    // A full counter already means "wake up", so a failed write is harmless
+    ssize_t n = write(rx->wake_fd, &one, sizeof(one));
+    (void)n;
+}
+
+bool osc_rx_pop(osc_receiver* rx, osc_event* ev) {
+    osc_queue* q = &rx->queue;
+    uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (tail == head) return false;
+
+    uint32_t depth = head - tail;
+    if (depth > rx->depth_max) rx->depth_max = depth;
+
+    *ev = q->events[tail & (OSC_QUEUE_SIZE - 1)];
+    atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+    return true;
+}
+
+void osc_rx_applied(osc_receiver* rx, const osc_event* ev) {
+    // Scheduled events count from their due time, not from arrival
+    uint64_t ref = ev->due_ns > ev->recv_ns ? ev->due_ns : ev->recv_ns;
+
+    if (rx->pending_count == 0 || ref < rx->pending_oldest) {
+        rx->pending_oldest = ref;
+    }
+    rx->pending_count++;
+}
+
+void osc_rx_presented(osc_receiver* rx, uint64_t now_ns) {
+    if (rx->pending_count == 0) return;
+
+    rx->latency_ms = (double)(now_ns - rx->pending_oldest) / 1e6;
+    if (rx->latency_ms > rx->latency_max_ms) rx->latency_max_ms = rx->latency_ms;
+    rx->pending_count = 0;
+}
+
+void osc_rx_get_stats(osc_receiver* rx, osc_rx_stats* stats) {
+    uint32_t head = atomic_load_explicit(&rx->queue.head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&rx->queue.tail, memory_order_relaxed);
+
+    stats->received = atomic_load_explicit(&rx->received, memory_order_relaxed);
+    stats->recv_calls = atomic_load_explicit(&rx->recv_calls, memory_order_relaxed);
+    stats->parse_errors = atomic_load_explicit(&rx->parse_errors, memory_order_relaxed);
+    stats->bundles = atomic_load_explicit(&rx->bundles, memory_order_relaxed);
+    stats->dropped = atomic_load_explicit(&rx->dropped, memory_order_relaxed);
+    stats->depth = head - tail;
+    stats->depth_max = rx->depth_max;
+    stats->latency_ms = rx->latency_ms;
+    stats->latency_max_ms = rx->latency_max_ms;
+}
+
+// Converts an NTP timetag to a CLOCK_MONOTONIC due time. `clock_offset` is
+// CLOCK_REALTIME minus CLOCK_MONOTONIC in ns, sampled when the packet arrived.
+static uint64_t osc_timetag_to_due(uint64_t timetag, int64_t clock_offset) {
+    if (timetag == TINYOSC_TIMETAG_IMMEDIATELY) return 0;
+
+    uint64_t seconds = timetag >> 32;
+    if (seconds < OSC_NTP_UNIX_OFFSET) return 0;
+    uint64_t frac_ns = ((timetag & 0xFFFFFFFFull) * 1000000000ull) >> 32;
+    int64_t unix_ns = (int64_t)((seconds - OSC_NTP_UNIX_OFFSET) * 1000000000ull + frac_ns);
+    int64_t due = unix_ns - clock_offset;
+    return due > 0 ? (uint64_t)due : 0;
+}
+
+static void osc_rx_handle_message(osc_receiver* rx, char* packet, int len, uint64_t recv_ns, uint64_t due_ns) {
+    osc_event ev;
+    ev.recv_ns = recv_ns;
+    ev.due_ns = due_ns;
+
+    tosc_message msg;
+    if (len < 4 || tosc_parseMessage(&msg, packet, len) != 0 || !osc_decode_message(&msg, &ev)) {
+        atomic_fetch_add_explicit(&rx->parse_errors, 1, memory_order_relaxed);
+        return;
+    }
+    osc_queue_push(rx, &ev);
+}
+
+static void osc_rx_handle_element(osc_receiver* rx, char* packet, int len, uint64_t recv_ns,
+                                  int64_t clock_offset, uint64_t due_ns, int depth) {
+    if (len < 16 || !tosc_isBundle(packet)) {
+        osc_rx_handle_message(rx, packet, len, recv_ns, due_ns);
+        return;
+    }
+    if (depth >= OSC_BUNDLE_MAX_DEPTH) {
+        atomic_fetch_add_explicit(&rx->parse_errors, 1, memory_order_relaxed);
+        return;
+    }
+    atomic_fetch_add_explicit(&rx->bundles, 1, memory_order_relaxed);
+
+    tosc_bundle bundle;
+    tosc_parseBundle(&bundle, packet, len);
+    due_ns = osc_timetag_to_due(tosc_getTimetag(&bundle), clock_offset);
+
+    // Walk the elements ourselves so nested bundles and bad sizes are caught
+    // before tinyosc reads past the datagram
+    char* end = packet + len;
+    char* marker = bundle.marker;
+    while (end - marker >= 4) {
+        int32_t size = (int32_t)ntohl(*(uint32_t*)marker);
+        marker += 4;
+        if (size <= 0 || size > end - marker) {
+            atomic_fetch_add_explicit(&rx->parse_errors, 1, memory_order_relaxed);
+            return;
+        }
+        osc_rx_handle_element(rx, marker, size, recv_ns, clock_offset, due_ns, depth + 1);
+        marker += size;
+    }
+}
+
+// Parses one datagram in place and queues the decoded events
+static void osc_rx_handle_packet(osc_receiver* rx, char* packet, int len, uint64_t recv_ns) {
+    int64_t clock_offset = 0;
+
+    if (len >= 16 && tosc_isBundle(packet)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        int64_t real_ns = (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+        clock_offset = real_ns - (int64_t)osc_now_ns();
+    }
+    osc_rx_handle_element(rx, packet, len, recv_ns, clock_offset, 0, 0);
+}
+
+static void osc_rx_read_single(osc_receiver* rx) {
+    char* packet = rx->arena->packets[0];
+
+    // Drain everything the kernel has queued before blocking again
+    while (1) {
+        int len = (int)recvfrom(rx->fd, packet, OSC_PACKET_SIZE, 0, NULL, NULL);
+        if (len <= 0) {
+            if (len < 0 && errno == EINTR) continue;
+            return;
+        }
+        atomic_fetch_add_explicit(&rx->received, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&rx->recv_calls, 1, memory_order_relaxed);
+        osc_rx_handle_packet(rx, packet, len, osc_now_ns());
+    }
+}
+
+#ifdef __linux__
+static void osc_rx_read_batch(osc_receiver* rx) {
+    osc_rx_arena* arena = rx->arena;
+
+    while (1) {
+        for (int i = 0; i < OSC_RX_BATCH; i++) {
+            arena->msgs[i].msg_hdr.msg_flags = 0;
+        }
+
+        int count = recvmmsg(rx->fd, arena->msgs, OSC_RX_BATCH, MSG_DONTWAIT, NULL);
+        if (count <= 0) {
+            if (count < 0 && errno == EINTR) continue;
+            return;
+        }
+        uint64_t recv_ns = osc_now_ns();
+        atomic_fetch_add_explicit(&rx->received, (uint64_t)count, memory_order_relaxed);
+        atomic_fetch_add_explicit(&rx->recv_calls, 1, memory_order_relaxed);
+
+        for (int i = 0; i < count; i++) {
+            if (arena->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                atomic_fetch_add_explicit(&rx->parse_errors, 1, memory_order_relaxed);
+                continue;
+            }
+            osc_rx_handle_packet(rx, arena->packets[i], (int)arena->msgs[i].msg_len, recv_ns);
+        }
+
+        // A short batch means the backlog is empty
+        if (count < OSC_RX_BATCH) return;
+    }
+}
+#endif
+
+static void* osc_rx_thread(void* arg) {
+    osc_receiver* rx = (osc_receiver*)arg;
+    struct pollfd pfd;
+    pfd.fd = rx->fd;
+    pfd.events = POLLIN;
+
+    while (atomic_load_explicit(&rx->running, memory_order_relaxed)) {
+        int ready = poll(&pfd, 1, OSC_RX_POLL_MS);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (ready > 0 && (pfd.revents & POLLIN)) {
+            uint32_t head = atomic_load_explicit(&rx->queue.head, memory_order_relaxed);
+#ifdef __linux__
+            if (rx->mode == OSC_RX_BATCH_RECV) osc_rx_read_batch(rx);
+            else osc_rx_read_single(rx);
+#else
+            osc_rx_read_single(rx);
+#endif
+            if (atomic_load_explicit(&rx->queue.head, memory_order_relaxed) != head) osc_rx_notify(rx);
+        }
+    }
+    return NULL;
+}
+
+bool osc_rx_start(osc_receiver* rx, int port, osc_rx_mode mode) {
+    rx->mode = mode;
+    atomic_store(&rx->queue.head, 0);
+    atomic_store(&rx->queue.tail, 0);
+    atomic_store(&rx->received, 0);
+    atomic_store(&rx->recv_calls, 0);
+    atomic_store(&rx->parse_errors, 0);
+    atomic_store(&rx->bundles, 0);
+    atomic_store(&rx->dropped, 0);
+    rx->depth_max = 0;
+    rx->pending_count = 0;
+    rx->pending_oldest = 0;
+    rx->latency_ms = 0.0;
+    rx->latency_max_ms = 0.0;
+
+    rx->arena = aligned_alloc(OSC_CACHE_LINE, sizeof(osc_rx_arena));
+    if (!rx->arena) {
+        printf("Error: Could not allocate OSC packet arena\n");
+        return false;
+    }
+    memset(rx->arena, 0, sizeof(osc_rx_arena));
+
+    // Point every message header at its arena slot once
+    for (int i = 0; i < OSC_RX_BATCH; i++) {
+        rx->arena->iov[i].iov_base = rx->arena->packets[i];
+        rx->arena->iov[i].iov_len = OSC_PACKET_SIZE;
+#ifdef __linux__
+        rx->arena->msgs[i].msg_hdr.msg_iov = &rx->arena->iov[i];
+        rx->arena->msgs[i].msg_hdr.msg_iovlen = 1;
+#endif
+    }
+
+    rx->wake_fd = -1;
+    rx->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (rx->fd < 0) {
+        printf("Error: Could not create socket\n");
+        free(rx->arena);
+        return false;
+    }
+    fcntl(rx->fd, F_SETFL, O_NONBLOCK);
+
+    // Room for a few batches worth of burst while the thread is busy
+    int rcvbuf = OSC_RX_BATCH * OSC_PACKET_SIZE * 4;
+    setsockopt(rx->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_in sin;
+    memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = INADDR_ANY;
+    if (bind(rx->fd, (struct sockaddr*)&sin, sizeof(struct sockaddr_in)) < 0) {
+        printf("Error: Could not bind port %d\n", port);
+        close(rx->fd);
+        free(rx->arena);
+        return false;
+    }
+
+#ifdef __linux__
+    rx->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+
+    // Keep SIGINT and friends on the render thread
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    atomic_store(&rx->running, true);
+    int err = pthread_create(&rx->thread, NULL, osc_rx_thread, rx);
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (err != 0) {
+        printf("Error: Could not start OSC receiver thread\n");
+        atomic_store(&rx->running, false);
+        if (rx->wake_fd >= 0) close(rx->wake_fd);
+        close(rx->fd);
+        free(rx->arena);
+        return false;
+    }
+    return true;
+}
+
+void osc_rx_stop(osc_receiver* rx) {
+    atomic_store(&rx->running, false);
+    pthread_join(rx->thread, NULL);
+    if (rx->wake_fd >= 0) close(rx->wake_fd);
+    close(rx->fd);
+    free(rx->arena);
+    rx->arena = NULL;
+}
@@ -0,0 +1,110 @@
+#ifndef _OSC_RX_H_
+#define _OSC_RX_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "osc_decode.h"
+
+// OSC receiver thread.
+//
+// A dedicated thread blocks on the UDP socket with poll(), parses every
+// datagram with tinyosc and pushes the decoded events into a lock-free
+// single-producer/single-consumer ring. The render loop drains the ring at
+// the start of each frame.
+//
+// In batch mode the thread pulls up to OSC_RX_BATCH datagrams per syscall
+// with recvmmsg() into a preallocated, cache-aligned packet arena and parses
+// them in place, repeating until the socket backlog is empty.
+//
+// After every read that queued events the thread signals `wake_fd` (an
+// eventfd, Linux only) so a render loop sleeping in poll() can present them
+// right away instead of at its next frame deadline.
+//
+// Bundles (including nested ones) are unpacked on the receiver thread. Every
+// event carries the bundle timetag converted to a CLOCK_MONOTONIC due time so
+// the render loop can hold it back until then (see osc_sched.h).
+
+#define OSC_QUEUE_SIZE 1024 // must be a power of two
+#define OSC_CACHE_LINE 64
+#define OSC_PACKET_SIZE 2048 // multiple of OSC_CACHE_LINE
+#define OSC_RX_BATCH 64      // datagrams per recvmmsg() call
+#define OSC_BUNDLE_MAX_DEPTH 8
+
+typedef enum osc_rx_mode {
+    OSC_RX_SINGLE, // one recvfrom() per datagram
+    OSC_RX_BATCH_RECV, // recvmmsg() into the packet arena (Linux only)
+} osc_rx_mode;
+
+typedef struct osc_queue {
+    _Alignas(OSC_CACHE_LINE) _Atomic uint32_t head; // written by the producer
+    _Alignas(OSC_CACHE_LINE) _Atomic uint32_t tail; // written by the consumer
+    _Alignas(OSC_CACHE_LINE) osc_event events[OSC_QUEUE_SIZE];
+} osc_queue;
+
+typedef struct osc_rx_stats {
+    uint64_t received;      // datagrams read from the socket
+    uint64_t recv_calls;    // receive syscalls that returned data
+    uint64_t parse_errors;  // datagrams tinyosc rejected
+    uint64_t bundles;       // bundles unpacked, nested ones included
+    uint64_t dropped;       // events lost because the queue was full
+    uint32_t depth;         // events waiting in the queue right now
+    uint32_t depth_max;     // highest depth seen when draining
+    double latency_ms;      // receive (or due) to display latency of the last frame
+    double latency_max_ms;
+} osc_rx_stats;
+
+typedef struct osc_receiver {
+    int fd;
+    int wake_fd; // readable when events were queued, -1 when unsupported
+    osc_rx_mode mode;
+    pthread_t thread;
+    atomic_bool running;
+    osc_queue queue;
+
+    // Packet arena, allocated once at start and only touched by the
+    // receiver thread
+    struct osc_rx_arena* arena;
+
+    // Producer counters
+    _Atomic uint64_t received;
+    _Atomic uint64_t recv_calls;
+    _Atomic uint64_t parse_errors;
+    _Atomic uint64_t bundles;
+    _Atomic uint64_t dropped;
+
+    // Consumer side, only touched by the render thread
+    uint32_t depth_max;
+    uint32_t pending_count;   // events applied since the last present
+    uint64_t pending_oldest;  // earliest recv/due time among them
+    double latency_ms;
+    double latency_max_ms;
+} osc_receiver;
+
+static inline uint64_t osc_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Binds a UDP socket on `port` and starts the receiver thread. Batch mode
+// falls back to single reads where recvmmsg() is not available.
+bool osc_rx_start(osc_receiver* rx, int port, osc_rx_mode mode);
+void osc_rx_stop(osc_receiver* rx);
+
+// Pops the next event. Only call from the render thread.
+bool osc_rx_pop(osc_receiver* rx, osc_event* ev);
+
+// Records that `ev` was applied to the display state this frame
+void osc_rx_applied(osc_receiver* rx, const osc_event* ev);
+
+// Marks everything applied so far as displayed at `now_ns`
+void osc_rx_presented(osc_receiver* rx, uint64_t now_ns);
+
+void osc_rx_get_stats(osc_receiver* rx, osc_rx_stats* stats);
+
+#endif /* _OSC_RX_H_ */
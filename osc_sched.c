@@ -0,0 +1,75 @@
+#include "osc_sched.h"
+
+static inline bool osc_sched_less(const osc_sched_entry* a, const osc_sched_entry* b) {
+    if (a->due_ns != b->due_ns) return a->due_ns < b->due_ns;
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+void osc_sched_init(osc_sched* s) {
+    s->count = 0;
+    s->seq = 0;
+    s->scheduled = 0;
+    s->overflow = 0;
+    s->rejected = 0;
+    s->free_count = OSC_SCHED_CAPACITY;
+    for (uint32_t i = 0; i < OSC_SCHED_CAPACITY; i++) {
+        s->free_slots[i] = OSC_SCHED_CAPACITY - 1 - i;
+    }
+}
+
+bool osc_sched_push(osc_sched* s, const osc_event* ev, uint64_t now_ns) {
+    if (ev->due_ns > now_ns && ev->due_ns - now_ns > OSC_SCHED_HORIZON_NS) {
+        s->rejected++;
+        return true;
+    }
+    if (s->free_count == 0) {
+        s->overflow++;
+        return false;
+    }
+
+    uint32_t slot = s->free_slots[--s->free_count];
+    s->events[slot] = *ev;
+
+    osc_sched_entry entry;
+    entry.due_ns = ev->due_ns;
+    entry.seq = s->seq++;
+    entry.slot = slot;
+
+    // Sift up
+    uint32_t i = s->count++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (!osc_sched_less(&entry, &s->heap[parent])) break;
+        s->heap[i] = s->heap[parent];
+        i = parent;
+    }
+    s->heap[i] = entry;
+    s->scheduled++;
+    return true;
+}
+
+bool osc_sched_pop_due(osc_sched* s, uint64_t now_ns, osc_event* ev) {
+    if (s->count == 0 || s->heap[0].due_ns > now_ns) return false;
+
+    uint32_t slot = s->heap[0].slot;
+    *ev = s->events[slot];
+    s->free_slots[s->free_count++] = slot;
+
+    // Sift the last entry down from the root
+    osc_sched_entry last = s->heap[--s->count];
+    uint32_t i = 0;
+    while (1) {
+        uint32_t child = i * 2 + 1;
+        if (child >= s->count) break;
+        if (child + 1 < s->count && osc_sched_less(&s->heap[child + 1], &s->heap[child])) child++;
+        if (!osc_sched_less(&s->heap[child], &last)) break;
+        s->heap[i] = s->heap[child];
+        i = child;
+    }
+    s->heap[i] = last;
+    return true;
+}
+
+uint64_t osc_sched_next_due(const osc_sched* s) {
+    return s->count > 0 ? s->heap[0].due_ns : UINT64_MAX;
+}
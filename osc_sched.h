@@ -0,0 +1,56 @@
+#ifndef _OSC_SCHED_H_
+#define _OSC_SCHED_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "osc_rx.h"
+
+// Timetag scheduler.
+//
+// Events taken from bundles with a timetag in the future wait in a fixed
+// capacity min-heap ordered by due time (CLOCK_MONOTONIC ns) and are handed
+// back to the render loop once that time has passed. Events with the same
+// due time keep their arrival order. Nothing is allocated after init.
+//
+// Timetags more than OSC_SCHED_HORIZON_NS ahead are taken as bogus (a wrong
+// clock or an unset field) and dropped, so they cannot sit in the heap for
+// good and crowd out real events.
+
+#define OSC_SCHED_CAPACITY 4096
+#define OSC_SCHED_HORIZON_NS 4000000000ull
+
+typedef struct osc_sched_entry {
+    uint64_t due_ns;
+    uint32_t seq;   // arrival order, breaks ties
+    uint32_t slot;  // index into osc_sched.events
+} osc_sched_entry;
+
+typedef struct osc_sched {
+    osc_sched_entry heap[OSC_SCHED_CAPACITY];
+    uint32_t count;
+    uint32_t seq;
+
+    // Event storage, reused through a free list
+    osc_event events[OSC_SCHED_CAPACITY];
+    uint32_t free_slots[OSC_SCHED_CAPACITY];
+    uint32_t free_count;
+
+    uint64_t scheduled; // events that went through the heap
+    uint64_t overflow;  // events applied early because the heap was full
+    uint64_t rejected;  // events dropped for a due time beyond the horizon
+} osc_sched;
+
+void osc_sched_init(osc_sched* s);
+
+// Queues `ev` until ev->due_ns, or drops it when that is more than
+// OSC_SCHED_HORIZON_NS after now_ns. Returns false if the heap is full.
+bool osc_sched_push(osc_sched* s, const osc_event* ev, uint64_t now_ns);
+
+// Pops the earliest event whose due time is <= now_ns
+bool osc_sched_pop_due(osc_sched* s, uint64_t now_ns, osc_event* ev);
+
+// Due time of the earliest event, UINT64_MAX when empty
+uint64_t osc_sched_next_due(const osc_sched* s);
+
+#endif /* _OSC_SCHED_H_ */
@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "overlay.h"
+
+bool overlay_init(overlay* o, int width, overlay_mode mode) {
+    memset(o, 0, sizeof(*o));
+    o->mode = mode;
+    return overlay_resize(o, width);
+}
+
+void overlay_free(overlay* o) {
+    free(o->row_depth);
+    free(o->row_glyph);
+    free(o->row_attr);
+    o->row_depth = NULL;
+    o->row_glyph = NULL;
+    o->row_attr = NULL;
+    o->width = 0;
+}
+
+bool overlay_resize(overlay* o, int width) {
+    if (width == o->width && o->row_glyph) return true;
+    overlay_free(o);
+
+    o->row_depth = malloc(sizeof(float) * (size_t)width);
+    o->row_glyph = malloc((size_t)width);
+    o->row_attr = malloc((size_t)width);
+    if (!o->row_depth || !o->row_glyph || !o->row_attr) {
+        overlay_free(o);
+        return false;
+    }
+    o->width = width;
+    return true;
+}
+
+bool overlay_parse_mode(const char* name, overlay_mode* mode) {
+    if (strcmp(name, "displace") == 0) *mode = OVERLAY_DISPLACE;
+    else if (strcmp(name, "overwrite") == 0) *mode = OVERLAY_OVERWRITE;
+    else if (strcmp(name, "behind") == 0) *mode = OVERLAY_BEHIND;
+    else return false;
+    return true;
+}
+
+void overlay_line_begin(overlay* o, int line, int y) {
+    if (line < 0 || line >= OVERLAY_MAX_LINES) return;
+    o->lines[line].visible = true;
+    o->lines[line].y = y;
+    o->lines[line].segment_count = 0;
+}
+
+void overlay_line_hide(overlay* o, int line) {
+    if (line < 0 || line >= OVERLAY_MAX_LINES) return;
+    o->lines[line].visible = false;
+}
+
+void overlay_line_add(overlay* o, int line, int x, const char* text, int len, uint8_t attr) {
+    if (line < 0 || line >= OVERLAY_MAX_LINES || len <= 0) return;
+    overlay_line* l = &o->lines[line];
+    if (l->segment_count >= OVERLAY_MAX_SEGMENTS) return;
+
+    overlay_segment* seg = &l->segments[l->segment_count++];
+    if (len > OVERLAY_SEGMENT_MAX) len = OVERLAY_SEGMENT_MAX;
+    seg->x = x < 0 ? 0 : x;
+    seg->len = (uint8_t)len;
+    seg->attr = attr | FB_ATTR_TEXT;
+    for (int i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)text[i];
+        seg->glyph[i] = (c >= 0x20 && c < 0x7F) ? c : '?';
+    }
+}
+
+// Text inserted into the row, the model cells flowing around it
+static void overlay_displace_row(const overlay* o, const overlay_line* l, uint8_t* glyph, uint8_t* attr, float* depth,
+                                 int width) {
+    uint8_t* out_glyph = o->row_glyph;
+    uint8_t* out_attr = o->row_attr;
+    float* out_depth = o->row_depth;
+    int out = 0, src = 0;
+
+    for (int s = 0; s < l->segment_count && out < width; s++) {
+        const overlay_segment* seg = &l->segments[s];
+        int target = seg->x < width ? seg->x : width;
+        int run = target - out;
+        if (run > 0) {
+            memcpy(out_glyph + out, glyph + src, (size_t)run);
+            memcpy(out_attr + out, attr + src, (size_t)run);
+            memcpy(out_depth + out, depth + src, (size_t)run * sizeof(float));
+            out += run;
+            src += run;
+        }
+        for (int i = 0; i < seg->len && out < width; i++, out++) {
+            out_glyph[out] = seg->glyph[i];
+            out_attr[out] = seg->attr;
+            out_depth[out] = FB_DEPTH_TEXT;
+        }
+    }
+
+    int run = width - out;
+    memcpy(out_glyph + out, glyph + src, (size_t)run);
+    memcpy(out_attr + out, attr + src, (size_t)run);
+    memcpy(out_depth + out, depth + src, (size_t)run * sizeof(float));
+
+    memcpy(glyph, out_glyph, (size_t)width);
+    memcpy(attr, out_attr, (size_t)width);
+    memcpy(depth, out_depth, (size_t)width * sizeof(float));
+}
+
+// Text written in place; `behind` skips cells the model drew into
+static void overlay_write_row(const overlay_line* l, uint8_t* glyph, uint8_t* attr, float* depth, int width, bool behind) {
+    for (int s = 0; s < l->segment_count; s++) {
+        const overlay_segment* seg = &l->segments[s];
+        for (int i = 0; i < seg->len && seg->x + i < width; i++) {
+            int x = seg->x + i;
+            if (behind && depth[x] != FB_DEPTH_CLEAR) continue;
+            glyph[x] = seg->glyph[i];
+            attr[x] = seg->attr;
+            depth[x] = FB_DEPTH_TEXT;
+        }
+    }
+}
+
+void overlay_composite(const overlay* o, framebuffer* fb) {
+    const int width = fb->width < o->width ? fb->width : o->width;
+
+    for (int i = 0; i < OVERLAY_MAX_LINES; i++) {
+        const overlay_line* l = &o->lines[i];
+        if (!l->visible || l->segment_count == 0 || l->y < 0 || l->y >= fb->height) continue;
+
+        size_t row = (size_t)l->y * fb->width;
+        uint8_t* glyph = fb->glyph + row;
+        uint8_t* attr = fb->attr + row;
+        float* depth = fb->depth + row;
+
+        if (o->mode == OVERLAY_DISPLACE) overlay_displace_row(o, l, glyph, attr, depth, width);
+        else overlay_write_row(l, glyph, attr, depth, width, o->mode == OVERLAY_BEHIND);
+    }
+}
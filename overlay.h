@@ -0,0 +1,76 @@
+#ifndef _OVERLAY_H_
+#define _OVERLAY_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "framebuffer.h"
+
+// Text overlay layer.
+//
+// Each line is a list of pre-formatted glyph runs (segments) at fixed cells.
+// Lines are only rebuilt by their owner when the data behind them changes;
+// every frame the layer is merged onto the 3D layer in a single pass per
+// row, without any string formatting. How text meets the model is set by
+// the overlay mode:
+//   displace  - text is inserted and pushes the rest of the row right, the
+//               original corrupted look
+//   overwrite - text replaces the cells under it
+//   behind    - text only shows in cells the model left empty
+
+#define OVERLAY_MAX_LINES 64
+#define OVERLAY_MAX_SEGMENTS 8
+#define OVERLAY_SEGMENT_MAX 32
+
+typedef enum overlay_mode {
+    OVERLAY_DISPLACE,
+    OVERLAY_OVERWRITE,
+    OVERLAY_BEHIND,
+} overlay_mode;
+
+typedef struct overlay_segment {
+    int x;
+    uint8_t len;
+    uint8_t attr;
+    uint8_t glyph[OVERLAY_SEGMENT_MAX];
+} overlay_segment;
+
+typedef struct overlay_line {
+    bool visible;
+    int y;
+    int segment_count; // segments are kept in ascending x order
+    overlay_segment segments[OVERLAY_MAX_SEGMENTS];
+} overlay_line;
+
+typedef struct overlay {
+    overlay_mode mode;
+    overlay_line lines[OVERLAY_MAX_LINES];
+
+    // One row of scratch for the displace merge, sized at init
+    int width;
+    uint8_t* row_glyph;
+    uint8_t* row_attr;
+    float* row_depth;
+} overlay;
+
+bool overlay_init(overlay* o, int width, overlay_mode mode);
+void overlay_free(overlay* o);
+bool overlay_resize(overlay* o, int width);
+
+// Parses "displace", "overwrite" or "behind"
+bool overlay_parse_mode(const char* name, overlay_mode* mode);
+
+// Empties `line` and places it on row `y`, visible
+void overlay_line_begin(overlay* o, int line, int y);
+
+// Hides `line` until the next overlay_line_begin
+void overlay_line_hide(overlay* o, int line);
+
+// Appends a run of `len` characters at cell `x`. Runs must be added left to
+// right; characters outside printable ASCII show as '?'.
+void overlay_line_add(overlay* o, int line, int x, const char* text, int len, uint8_t attr);
+
+// Merges every visible line into `fb`
+void overlay_composite(const overlay* o, framebuffer* fb);
+
+#endif /* _OVERLAY_H_ */
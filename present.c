@@ -0,0 +1,239 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "present.h"
+
+// Unchanged cells between two changed ones are re-emitted instead of moving
+// the cursor when the gap is at most this wide (a CUP escape is ~8 bytes)
+#define PRESENT_MAX_GAP 4
+
+static const char* present_sgr[FB_COLOR_COUNT] = {
+    "\033[0m",  // default
+    "\033[31m", // red
+    "\033[33m", // yellow
+    "\033[37m", // white
+};
+
+static inline void present_put(present_state* p, const char* s, size_t len) {
+    if (p->out_len + len > p->out_cap) return;
+    memcpy(p->out + p->out_len, s, len);
+    p->out_len += len;
+}
+
+static inline void present_put_str(present_state* p, const char* s) {
+    present_put(p, s, strlen(s));
+}
+
+static void present_put_uint(present_state* p, unsigned int v) {
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v > 0);
+    while (n > 0 && p->out_len < p->out_cap) {
+        p->out[p->out_len++] = tmp[--n];
+    }
+}
+
+// Moves the cursor to the zero-based cell (x, y)
+static void present_move(present_state* p, int x, int y) {
+    present_put(p, "\033[", 2);
+    present_put_uint(p, (unsigned int)(y + 1));
+    present_put(p, ";", 1);
+    present_put_uint(p, (unsigned int)(x + 1));
+    present_put(p, "H", 1);
+    p->cur_x = x;
+    p->cur_y = y;
+}
+
+static void present_set_color(present_state* p, int color) {
+    if (color == p->cur_color) return;
+    if (color < 0 || color >= FB_COLOR_COUNT) color = FB_COLOR_DEFAULT;
+    present_put_str(p, present_sgr[color]);
+    p->cur_color = color;
+}
+
+static inline void present_put_cell(present_state* p, uint8_t glyph, uint8_t attr) {
+    const fb_glyph* g = &fb_glyphs[glyph];
+    present_set_color(p, attr & FB_COLOR_MASK);
+    present_put(p, g->utf8, g->len);
+}
+
+// Writes at most `columns` visible characters of `s` (and at most
+// PRESENT_FOOTER_MAX - 1 bytes), so the line never wraps. Escape sequences
+// are copied whole without taking a column; one cut short by a truncated
+// string is dropped rather than left open.
+static void present_put_clipped(present_state* p, const char* s, int columns) {
+    size_t len = strnlen(s, PRESENT_FOOTER_MAX - 1);
+    size_t i = 0;
+    while (i < len) {
+        if (s[i] == '\033') {
+            size_t j = i + 1;
+            if (j < len && s[j] == '[') {
+                j++;
+                while (j < len && (uint8_t)s[j] >= 0x20 && (uint8_t)s[j] < 0x40) j++;
+            }
+            if (j >= len) break;
+            present_put(p, s + i, j + 1 - i);
+            i = j + 1;
+            continue;
+        }
+
+        // One UTF-8 character
+        uint8_t lead = (uint8_t)s[i];
+        size_t j = i + (lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1);
+        if (j > len) break;
+        if (columns == 0) {
+            i = j;
+            continue;
+        }
+        present_put(p, s + i, j - i);
+        columns--;
+        i = j;
+    }
+}
+
+static void present_write_all(const char* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDOUT_FILENO, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+bool present_init(present_state* p, int width, int height) {
+    size_t count = (size_t)width * (size_t)height;
+
+    memset(p, 0, sizeof(*p));
+    p->width = width;
+    p->height = height;
+    p->prev_glyph = malloc(count);
+    p->prev_attr = malloc(count);
+
+    // Worst case per cell: cursor move + color escape + 4-byte glyph, plus
+    // the separator (3-byte glyphs), footer and terminal setup
+    p->out_cap = count * 24 + (size_t)width * 3 + PRESENT_FOOTER_MAX + 256;
+    p->out = malloc(p->out_cap);
+
+    if (!p->prev_glyph || !p->prev_attr || !p->out) {
+        present_free(p);
+        return false;
+    }
+    p->full_redraw = true;
+    return true;
+}
+
+void present_free(present_state* p) {
+    free(p->prev_glyph);
+    free(p->prev_attr);
+    free(p->out);
+    p->prev_glyph = NULL;
+    p->prev_attr = NULL;
+    p->out = NULL;
+}
+
+bool present_resize(present_state* p, int width, int height) {
+    if (width == p->width && height == p->height) {
+        p->full_redraw = true;
+        return true;
+    }
+    present_free(p);
+    return present_init(p, width, height);
+}
+
+bool present_terminal_size(int* cols, int* rows) {
+    struct winsize ws;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) != 0 || ws.ws_col == 0 || ws.ws_row == 0) {
+        return false;
+    }
+    *cols = ws.ws_col;
+    *rows = ws.ws_row;
+    return true;
+}
+
+void present_invalidate(present_state* p) {
+    p->full_redraw = true;
+}
+
+size_t present_compose(present_state* p, const framebuffer* fb, const char* footer) {
+    const bool full = p->full_redraw;
+    const uint8_t* glyph = fb->glyph;
+    const uint8_t* attr = fb->attr;
+
+    p->out_len = 0;
+    p->cur_x = -1;
+    p->cur_y = -1;
+
+    if (full) {
+        // Hide the cursor, reset attributes and clear once
+        present_put_str(p, "\033[?25l\033[0m\033[2J");
+        p->cur_color = FB_COLOR_DEFAULT;
+        p->prev_footer[0] = '\0';
+    }
+
+    for (int y = 0; y < p->height; y++) {
+        const int row = y * p->width;
+        for (int x = 0; x < p->width; x++) {
+            const int i = row + x;
+            if (!full && glyph[i] == p->prev_glyph[i] && attr[i] == p->prev_attr[i]) {
+                continue;
+            }
+
+            if (p->cur_y != y || p->cur_x > x || x - p->cur_x > PRESENT_MAX_GAP) {
+                present_move(p, x, y);
+            } else {
+                // Cheaper to repeat the unchanged cells than to jump over them
+                for (int g = row + p->cur_x; g < i; g++) {
+                    present_put_cell(p, glyph[g], attr[g]);
+                }
+            }
+
+            present_put_cell(p, glyph[i], attr[i]);
+            p->cur_x = x + 1;
+
+            p->prev_glyph[i] = glyph[i];
+            p->prev_attr[i] = attr[i];
+        }
+    }
+
+    if (full) {
+        present_move(p, 0, p->height);
+        for (int i = 0; i < p->width; i++) present_put_cell(p, GLYPH_HLINE, FB_COLOR_WHITE);
+    }
+    present_set_color(p, FB_COLOR_DEFAULT);
+
+    if (footer && strncmp(footer, p->prev_footer, PRESENT_FOOTER_MAX) != 0) {
+        present_move(p, 0, p->height + 1);
+        present_put_clipped(p, footer, p->width);
+        present_put_str(p, "\033[0m\033[K");
+        strncpy(p->prev_footer, footer, PRESENT_FOOTER_MAX - 1);
+        p->prev_footer[PRESENT_FOOTER_MAX - 1] = '\0';
+    }
+
+    p->full_redraw = false;
+    p->last_bytes = p->out_len;
+    return p->out_len;
+}
+
+size_t present_frame(present_state* p, const framebuffer* fb, const char* footer) {
+    size_t len = present_compose(p, fb, footer);
+    present_write_all(p->out, len);
+    return len;
+}
+
+void present_restore_terminal(present_state* p) {
+    p->out_len = 0;
+    present_put_str(p, "\033[0m");
+    present_move(p, 0, p->height + 2);
+    present_put_str(p, "\033[?25h");
+    present_write_all(p->out, p->out_len);
+    p->cur_color = FB_COLOR_DEFAULT;
+}
@@ -0,0 +1,71 @@
+#ifndef _PRESENT_H_
+#define _PRESENT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "framebuffer.h"
+
+// Diff-based terminal presenter.
+//
+// Keeps a copy of the last frame sent to the terminal and only emits the runs
+// of cells that changed, using cursor-positioning escapes. Color escapes are
+// only written when the color actually changes and the whole frame goes out
+// with a single write(), so output bytes scale with how much of the frame is
+// moving rather than with width * height.
+
+#define PRESENT_FOOTER_MAX 256 // bytes including escapes; the visible part is clipped to the width
+
+// Terminal rows used below the frame: separator and footer
+#define PRESENT_EXTRA_ROWS 2
+
+typedef struct present_state {
+    int width;
+    int height;
+
+    // Last frame written to the terminal
+    uint8_t* prev_glyph;
+    uint8_t* prev_attr;
+    char prev_footer[PRESENT_FOOTER_MAX];
+    bool full_redraw;
+
+    // Output for the frame being built, sized once at init
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+
+    // Terminal state while building the frame
+    int cur_color;
+    int cur_x;
+    int cur_y;
+
+    size_t last_bytes; // bytes emitted by the last present_frame
+} present_state;
+
+bool present_init(present_state* p, int width, int height);
+void present_free(present_state* p);
+
+// Reallocates for a new frame size and forces a full repaint. Only meant for
+// actual size changes, never per frame.
+bool present_resize(present_state* p, int width, int height);
+
+// Terminal size in cells from TIOCGWINSZ. False when stdout is not a terminal.
+bool present_terminal_size(int* cols, int* rows);
+
+// Forces the next frame to repaint every cell
+void present_invalidate(present_state* p);
+
+// Emits the difference between `fb` and the previous frame, plus the footer
+// line if it changed, clipped to the frame width. Glyph ids are mapped to UTF-8 through fb_glyphs here.
+// Returns the number of bytes written to the terminal.
+size_t present_frame(present_state* p, const framebuffer* fb, const char* footer);
+
+// Builds the same output into p->out and updates the previous frame without
+// writing it anywhere. Returns its length.
+size_t present_compose(present_state* p, const framebuffer* fb, const char* footer);
+
+// Resets colors, shows the cursor and moves it below the frame
+void present_restore_terminal(present_state* p);
+
+#endif /* _PRESENT_H_ */
@@ -0,0 +1,332 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raster.h"
+
+// Darkest to brightest
+static const char raster_ramp[] = ".:-=+*#%@";
+#define RASTER_RAMP_LEN ((int)sizeof(raster_ramp) - 1)
+
+// Triangles reaching further than this off screen are dropped; they only
+// occur right in front of the camera and would overflow the edge functions
+#define RASTER_GUARD (1 << 13)
+
+#define RASTER_AMBIENT 0.15f
+#define RASTER_LIGHT_X -0.4f
+#define RASTER_LIGHT_Y -0.5f
+#define RASTER_LIGHT_Z -1.1f
+
+bool raster_init(raster_state* rs, int width, int height, uint32_t tri_count) {
+    rs->width = width;
+    rs->height = height;
+    rs->tiles_x = (width + RASTER_TILE_W - 1) / RASTER_TILE_W;
+    rs->tiles_y = (height + RASTER_TILE_H - 1) / RASTER_TILE_H;
+    rs->bin_tris = NULL;
+    rs->bin_cap = 0;
+    rs->tri_count = tri_count;
+    rs->band_edges = NULL;
+    rs->band_cap = 0;
+
+    rs->bin_start = calloc((size_t)rs->tiles_x * rs->tiles_y + 1, sizeof(uint32_t));
+    rs->tri_glyph = malloc(tri_count ? tri_count : 1);
+    rs->band_start = calloc((size_t)rs->tiles_y + 1, sizeof(uint32_t));
+    if (!rs->bin_start || !rs->tri_glyph || !rs->band_start) {
+        raster_free(rs);
+        return false;
+    }
+    return true;
+}
+
+void raster_free(raster_state* rs) {
+    free(rs->bin_start);
+    free(rs->bin_tris);
+    free(rs->tri_glyph);
+    free(rs->band_start);
+    free(rs->band_edges);
+    rs->bin_start = NULL;
+    rs->bin_tris = NULL;
+    rs->tri_glyph = NULL;
+    rs->band_start = NULL;
+    rs->band_edges = NULL;
+    rs->bin_cap = 0;
+    rs->band_cap = 0;
+}
+
+bool raster_resize(raster_state* rs, int width, int height) {
+    int tiles_x = (width + RASTER_TILE_W - 1) / RASTER_TILE_W;
+    int tiles_y = (height + RASTER_TILE_H - 1) / RASTER_TILE_H;
+    uint32_t* bin_start = calloc((size_t)tiles_x * tiles_y + 1, sizeof(uint32_t));
+    uint32_t* band_start = calloc((size_t)tiles_y + 1, sizeof(uint32_t));
+    if (!bin_start || !band_start) {
+        free(bin_start);
+        free(band_start);
+        return false;
+    }
+
+    free(rs->bin_start);
+    free(rs->band_start);
+    rs->bin_start = bin_start;
+    rs->band_start = band_start;
+    rs->width = width;
+    rs->height = height;
+    rs->tiles_x = tiles_x;
+    rs->tiles_y = tiles_y;
+    return true;
+}
+
+// Clamped screen bounding box of triangle `t`. False when it is off screen,
+// behind the camera or outside the guard band.
+static bool raster_tri_bounds(const raster_state* rs, const mesh* m, const xform_cache* cache, uint32_t t,
+                              int* min_x, int* min_y, int* max_x, int* max_y) {
+    const uint32_t* tri = m->tris + (size_t)t * 3;
+    int x0 = cache->sx[tri[0]], x1 = cache->sx[tri[1]], x2 = cache->sx[tri[2]];
+    int y0 = cache->sy[tri[0]], y1 = cache->sy[tri[1]], y2 = cache->sy[tri[2]];
+
+    if (!(cache->depth[tri[0]] > 0.0f && cache->depth[tri[1]] > 0.0f && cache->depth[tri[2]] > 0.0f)) return false;
+
+    int lo_x = x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2);
+    int hi_x = x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2);
+    int lo_y = y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2);
+    int hi_y = y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2);
+
+    if (lo_x < -RASTER_GUARD || hi_x > RASTER_GUARD || lo_y < -RASTER_GUARD || hi_y > RASTER_GUARD) return false;
+
+    if (lo_x < 0) lo_x = 0;
+    if (lo_y < 0) lo_y = 0;
+    if (hi_x > rs->width - 1) hi_x = rs->width - 1;
+    if (hi_y > rs->height - 1) hi_y = rs->height - 1;
+    if (lo_x > hi_x || lo_y > hi_y) return false;
+
+    *min_x = lo_x;
+    *min_y = lo_y;
+    *max_x = hi_x;
+    *max_y = hi_y;
+    return true;
+}
+
+bool raster_prepare(raster_state* rs, const mesh* m, const xform_cache* cache, const xform_mat3* rot) {
+    const int tile_count = rs->tiles_x * rs->tiles_y;
+    const float (*r)[3] = rot->m;
+    uint32_t count = m->tri_count < rs->tri_count ? m->tri_count : rs->tri_count;
+
+    // Direction towards the light in view space: up, left and in front
+    const float light_len = sqrtf(RASTER_LIGHT_X * RASTER_LIGHT_X + RASTER_LIGHT_Y * RASTER_LIGHT_Y + RASTER_LIGHT_Z * RASTER_LIGHT_Z);
+    const float lx = RASTER_LIGHT_X / light_len;
+    const float ly = RASTER_LIGHT_Y / light_len;
+    const float lz = RASTER_LIGHT_Z / light_len;
+
+    // Shade and count the tiles every visible triangle touches
+    memset(rs->bin_start, 0, ((size_t)tile_count + 1) * sizeof(uint32_t));
+    for (uint32_t t = 0; t < count; t++) {
+        int x0, y0, x1, y1;
+        rs->tri_glyph[t] = 0;
+        if (!cache->front[t] || !raster_tri_bounds(rs, m, cache, t, &x0, &y0, &x1, &y1)) continue;
+
+        float nx = m->tri_nx[t], ny = m->tri_ny[t], nz = m->tri_nz[t];
+        float vx = r[0][0] * nx + r[0][1] * ny + r[0][2] * nz;
+        float vy = r[1][0] * nx + r[1][1] * ny + r[1][2] * nz;
+        float vz = r[2][0] * nx + r[2][1] * ny + r[2][2] * nz;
+        float lambert = vx * lx + vy * ly + vz * lz;
+        if (lambert < 0.0f) lambert = 0.0f;
+        float lum = RASTER_AMBIENT + (1.0f - RASTER_AMBIENT) * lambert;
+        int level = (int)(lum * (RASTER_RAMP_LEN - 1) + 0.5f);
+        if (level > RASTER_RAMP_LEN - 1) level = RASTER_RAMP_LEN - 1;
+        rs->tri_glyph[t] = (uint8_t)raster_ramp[level];
+
+        for (int ty = y0 / RASTER_TILE_H; ty <= y1 / RASTER_TILE_H; ty++) {
+            for (int tx = x0 / RASTER_TILE_W; tx <= x1 / RASTER_TILE_W; tx++) {
+                rs->bin_start[ty * rs->tiles_x + tx]++;
+            }
+        }
+    }
+
+    // Inclusive prefix sum: bin_start[i] is the end of bin i for now
+    for (int i = 1; i < tile_count; i++) rs->bin_start[i] += rs->bin_start[i - 1];
+    size_t total = tile_count ? rs->bin_start[tile_count - 1] : 0;
+    rs->bin_start[tile_count] = (uint32_t)total;
+
+    if (total > rs->bin_cap) {
+        size_t cap = total + total / 2;
+        uint32_t* bins = realloc(rs->bin_tris, cap * sizeof(uint32_t));
+        if (!bins) {
+            memset(rs->bin_start, 0, ((size_t)tile_count + 1) * sizeof(uint32_t));
+            return false;
+        }
+        rs->bin_tris = bins;
+        rs->bin_cap = cap;
+    }
+
+    // Fill back to front so each bin ends up in ascending triangle order and
+    // bin_start[i] moves to the start of bin i
+    for (uint32_t t = count; t-- > 0;) {
+        int x0, y0, x1, y1;
+        if (!rs->tri_glyph[t]) continue;
+        raster_tri_bounds(rs, m, cache, t, &x0, &y0, &x1, &y1);
+        for (int ty = y0 / RASTER_TILE_H; ty <= y1 / RASTER_TILE_H; ty++) {
+            for (int tx = x0 / RASTER_TILE_W; tx <= x1 / RASTER_TILE_W; tx++) {
+                rs->bin_tris[--rs->bin_start[ty * rs->tiles_x + tx]] = t;
+            }
+        }
+    }
+    return true;
+}
+
+void raster_tile(const raster_state* rs, framebuffer* fb, const mesh* m, const xform_cache* cache, int tile, uint8_t attr) {
+    const int width = fb->width;
+    int tile_x0 = (tile % rs->tiles_x) * RASTER_TILE_W;
+    int tile_y0 = (tile / rs->tiles_x) * RASTER_TILE_H;
+    int tile_x1 = tile_x0 + RASTER_TILE_W - 1;
+    int tile_y1 = tile_y0 + RASTER_TILE_H - 1;
+    if (tile_x1 > width - 1) tile_x1 = width - 1;
+    if (tile_y1 > fb->height - 1) tile_y1 = fb->height - 1;
+
+    for (uint32_t b = rs->bin_start[tile]; b < rs->bin_start[tile + 1]; b++) {
+        uint32_t t = rs->bin_tris[b];
+        const uint32_t* tri = m->tris + (size_t)t * 3;
+        uint32_t i0 = tri[0], i1 = tri[1], i2 = tri[2];
+
+        int x0 = cache->sx[i0], y0 = cache->sy[i0];
+        int x1 = cache->sx[i1], y1 = cache->sy[i1];
+        int x2 = cache->sx[i2], y2 = cache->sy[i2];
+        int area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+        if (area == 0) continue;
+        if (area < 0) {
+            uint32_t ti = i1;
+            i1 = i2;
+            i2 = ti;
+            int tx = x1;
+            x1 = x2;
+            x2 = tx;
+            int ty = y1;
+            y1 = y2;
+            y2 = ty;
+            area = -area;
+        }
+
+        int min_x = x0 < x1 ? (x0 < x2 ? x0 : x2) : (x1 < x2 ? x1 : x2);
+        int max_x = x0 > x1 ? (x0 > x2 ? x0 : x2) : (x1 > x2 ? x1 : x2);
+        int min_y = y0 < y1 ? (y0 < y2 ? y0 : y2) : (y1 < y2 ? y1 : y2);
+        int max_y = y0 > y1 ? (y0 > y2 ? y0 : y2) : (y1 > y2 ? y1 : y2);
+        if (min_x < tile_x0) min_x = tile_x0;
+        if (min_y < tile_y0) min_y = tile_y0;
+        if (max_x > tile_x1) max_x = tile_x1;
+        if (max_y > tile_y1) max_y = tile_y1;
+        if (min_x > max_x || min_y > max_y) continue;
+
+        // Edge functions, nonnegative inside: w0 opposite v0, w1 opposite v1,
+        // w2 opposite v2. Steps per column (a) and per row (b).
+        int a0 = y1 - y2, b0 = x2 - x1;
+        int a1 = y2 - y0, b1 = x0 - x2;
+        int a2 = y0 - y1, b2 = x1 - x0;
+        int w0_row = b0 * (min_y - y1) + a0 * (min_x - x1);
+        int w1_row = b1 * (min_y - y2) + a1 * (min_x - x2);
+        int w2_row = b2 * (min_y - y0) + a2 * (min_x - x0);
+
+        // Depth is linear in screen space: d0 + (d1 - d0) * w1 / area + (d2 - d0) * w2 / area
+        float d0 = cache->depth[i0];
+        float e1 = (cache->depth[i1] - d0) / (float)area;
+        float e2 = (cache->depth[i2] - d0) / (float)area;
+        float dz_dx = e1 * (float)a1 + e2 * (float)a2;
+        float dz_dy = e1 * (float)b1 + e2 * (float)b2;
+        float z_row = d0 + e1 * (float)w1_row + e2 * (float)w2_row;
+
+        uint8_t glyph = rs->tri_glyph[t];
+        for (int y = min_y; y <= max_y; y++) {
+            int w0 = w0_row, w1 = w1_row, w2 = w2_row;
+            float z = z_row;
+            uint8_t* cell_glyph = fb->glyph + y * width;
+            uint8_t* cell_attr = fb->attr + y * width;
+            float* cell_depth = fb->depth + y * width;
+
+            for (int x = min_x; x <= max_x; x++) {
+                if ((w0 | w1 | w2) >= 0 && z > cell_depth[x]) {
+                    cell_glyph[x] = glyph;
+                    cell_attr[x] = attr;
+                    cell_depth[x] = z;
+                }
+                w0 += a0;
+                w1 += a1;
+                w2 += a2;
+                z += dz_dx;
+            }
+            w0_row += b0;
+            w1_row += b1;
+            w2_row += b2;
+            z_row += dz_dy;
+        }
+    }
+}
+
+// Row bands edge `e` can touch after clipping. False when it misses the screen
+// or is hidden.
+static bool raster_edge_bands(const raster_state* rs, const mesh* m, const xform_cache* cache, bool hidden_lines,
+                              uint32_t e, int* band0, int* band1) {
+    if (hidden_lines && !xform_edge_front(cache, m, e)) return false;
+
+    uint32_t v0 = m->edges[e * 2];
+    uint32_t v1 = m->edges[e * 2 + 1];
+    int x0 = cache->sx[v0], y0 = cache->sy[v0];
+    int x1 = cache->sx[v1], y1 = cache->sy[v1];
+
+    int lo_y = y0 < y1 ? y0 : y1;
+    int hi_y = y0 < y1 ? y1 : y0;
+    if (hi_y < 0 || lo_y > rs->height - 1) return false;
+    if ((x0 < 0 && x1 < 0) || (x0 > rs->width - 1 && x1 > rs->width - 1)) return false;
+
+    // Clipped endpoints stay on the segment, so rounding keeps them in [lo_y, hi_y]
+    if (lo_y < 0) lo_y = 0;
+    if (hi_y > rs->height - 1) hi_y = rs->height - 1;
+    *band0 = lo_y / RASTER_TILE_H;
+    *band1 = hi_y / RASTER_TILE_H;
+    return true;
+}
+
+bool raster_prepare_edges(raster_state* rs, const mesh* m, const xform_cache* cache, bool hidden_lines) {
+    const int band_count = rs->tiles_y;
+
+    memset(rs->band_start, 0, ((size_t)band_count + 1) * sizeof(uint32_t));
+    for (uint32_t e = 0; e < m->edge_count; e++) {
+        int b0, b1;
+        if (!raster_edge_bands(rs, m, cache, hidden_lines, e, &b0, &b1)) continue;
+        for (int b = b0; b <= b1; b++) rs->band_start[b]++;
+    }
+
+    for (int i = 1; i < band_count; i++) rs->band_start[i] += rs->band_start[i - 1];
+    size_t total = band_count ? rs->band_start[band_count - 1] : 0;
+    rs->band_start[band_count] = (uint32_t)total;
+
+    if (total > rs->band_cap) {
+        size_t cap = total + total / 2;
+        uint32_t* bands = realloc(rs->band_edges, cap * sizeof(uint32_t));
+        if (!bands) {
+            memset(rs->band_start, 0, ((size_t)band_count + 1) * sizeof(uint32_t));
+            return false;
+        }
+        rs->band_edges = bands;
+        rs->band_cap = cap;
+    }
+
+    // Same back to front fill as the triangle bins
+    for (uint32_t e = m->edge_count; e-- > 0;) {
+        int b0, b1;
+        if (!raster_edge_bands(rs, m, cache, hidden_lines, e, &b0, &b1)) continue;
+        for (int b = b0; b <= b1; b++) rs->band_edges[--rs->band_start[b]] = e;
+    }
+    return true;
+}
+
+void raster_band_edges(const raster_state* rs, framebuffer* fb, const mesh* m, const xform_cache* cache, int band,
+                       uint8_t glyph, uint8_t attr) {
+    int row_min = band * RASTER_TILE_H;
+    int row_max = row_min + RASTER_TILE_H - 1;
+    if (row_max > fb->height - 1) row_max = fb->height - 1;
+
+    for (uint32_t b = rs->band_start[band]; b < rs->band_start[band + 1]; b++) {
+        uint32_t e = rs->band_edges[b];
+        uint32_t v0 = m->edges[e * 2];
+        uint32_t v1 = m->edges[e * 2 + 1];
+        fb_draw_line_rows(fb, row_min, row_max, cache->sx[v0], cache->sy[v0], cache->depth[v0],
+                          cache->sx[v1], cache->sy[v1], cache->depth[v1], glyph, attr);
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef _RASTER_H_
+#define _RASTER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "framebuffer.h"
+#include "mesh.h"
+#include "transform.h"
+
+// Filled, depth-tested triangle rasterizer.
+//
+// Camera-facing triangles are shaded once per frame from their rotated normal
+// onto an ASCII luminance ramp, then binned into screen tiles. Each tile is
+// rasterized independently with integer edge functions over the projected
+// cell coordinates, so tiles can be handed to separate threads.
+//
+// Wireframe edges are binned the same way into row bands, one per row of
+// tiles, and each band only draws the cells of its own rows.
+
+#define RASTER_TILE_W 32
+#define RASTER_TILE_H 8
+
+typedef struct raster_state {
+    int width;
+    int height;
+    int tiles_x;
+    int tiles_y;
+    uint32_t* bin_start;  // tiles_x * tiles_y + 1 offsets into bin_tris
+    uint32_t* bin_tris;   // triangle ids grouped by tile
+    size_t bin_cap;
+    uint8_t* tri_glyph;   // ramp glyph per triangle for this frame
+    uint32_t tri_count;
+    uint32_t* band_start; // tiles_y + 1 offsets into band_edges
+    uint32_t* band_edges; // edge ids grouped by row band
+    size_t band_cap;
+} raster_state;
+
+bool raster_init(raster_state* rs, int width, int height, uint32_t tri_count);
+void raster_free(raster_state* rs);
+bool raster_resize(raster_state* rs, int width, int height);
+
+// Shades and bins the camera-facing triangles. `cache` must hold this
+// frame's projection and facing flags.
+bool raster_prepare(raster_state* rs, const mesh* m, const xform_cache* cache, const xform_mat3* rot);
+
+// Rasterizes the triangles binned to `tile` into `fb`
+void raster_tile(const raster_state* rs, framebuffer* fb, const mesh* m, const xform_cache* cache, int tile, uint8_t attr);
+
+// Bins the edges that reach the screen into row bands. With `hidden_lines`
+// only edges next to a camera-facing triangle are kept, which needs this
+// frame's facing flags in `cache`.
+bool raster_prepare_edges(raster_state* rs, const mesh* m, const xform_cache* cache, bool hidden_lines);
+
+// Draws the edges binned to row band `band` into the band's rows of `fb`
+void raster_band_edges(const raster_state* rs, framebuffer* fb, const mesh* m, const xform_cache* cache, int band,
+                       uint8_t glyph, uint8_t attr);
+
+#endif /* _RASTER_H_ */
@@ -0,0 +1,164 @@
+#include <signal.h>
+#include <unistd.h>
+
+#include "tile_pool.h"
+
+static inline uint64_t tile_pool_pack(uint32_t begin, uint32_t end) {
+    return (uint64_t)begin | ((uint64_t)end << 32);
+}
+
+// Takes the next item from the front of the thread's own range
+static bool tile_pool_pop(tile_pool_range* r, int* item) {
+    uint64_t cur = atomic_load_explicit(&r->items, memory_order_relaxed);
+    while (1) {
+        uint32_t begin = (uint32_t)cur, end = (uint32_t)(cur >> 32);
+        if (begin >= end) return false;
+        if (atomic_compare_exchange_weak_explicit(&r->items, &cur, tile_pool_pack(begin + 1, end),
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            *item = (int)begin;
+            return true;
+        }
+    }
+}
+
+// Takes the last item of another thread's range
+static bool tile_pool_steal(tile_pool_range* r, int* item) {
+    uint64_t cur = atomic_load_explicit(&r->items, memory_order_relaxed);
+    while (1) {
+        uint32_t begin = (uint32_t)cur, end = (uint32_t)(cur >> 32);
+        if (begin >= end) return false;
+        if (atomic_compare_exchange_weak_explicit(&r->items, &cur, tile_pool_pack(begin, end - 1),
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            *item = (int)(end - 1);
+            return true;
+        }
+    }
+}
+
+static void tile_pool_work(tile_pool* pool, int self) {
+    const int n = pool->thread_count;
+    int item;
+
+    while (1) {
+        while (tile_pool_pop(&pool->ranges[self], &item)) pool->fn(pool->ctx, item);
+
+        // Own range is empty: steal from the others, nearest first
+        bool stole = false;
+        for (int k = 1; k < n && !stole; k++) {
+            if (tile_pool_steal(&pool->ranges[(self + k) % n], &item)) {
+                pool->fn(pool->ctx, item);
+                stole = true;
+            }
+        }
+        if (!stole) return;
+    }
+}
+
+static void* tile_pool_thread(void* arg) {
+    tile_pool_worker* w = (tile_pool_worker*)arg;
+    tile_pool* pool = w->pool;
+    uint64_t seen = 0;
+
+    while (1) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->stop) pthread_cond_wait(&pool->start, &pool->lock);
+        if (pool->stop) {
+            pthread_mutex_unlock(&pool->lock);
+            return NULL;
+        }
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        tile_pool_work(pool, w->index);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->busy == 0) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+bool tile_pool_init(tile_pool* pool, int thread_count) {
+    if (thread_count <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = online > 0 ? (int)online : 1;
+    }
+    if (thread_count > TILE_POOL_MAX_THREADS) thread_count = TILE_POOL_MAX_THREADS;
+
+    pool->thread_count = 1;
+    pool->generation = 0;
+    pool->busy = 0;
+    pool->stop = false;
+    pool->fn = NULL;
+    pool->ctx = NULL;
+    for (int i = 0; i < TILE_POOL_MAX_THREADS; i++) atomic_init(&pool->ranges[i].items, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    // Keep SIGINT and friends on the render thread
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &old);
+
+    bool ok = true;
+    for (int i = 1; i < thread_count && ok; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        ok = pthread_create(&pool->threads[i], NULL, tile_pool_thread, &pool->workers[i]) == 0;
+        if (ok) pool->thread_count = i + 1;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+
+    if (!ok) {
+        tile_pool_free(pool);
+        return false;
+    }
+    return true;
+}
+
+void tile_pool_free(tile_pool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->thread_count; i++) pthread_join(pool->threads[i], NULL);
+    pool->thread_count = 1;
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+void tile_pool_run(tile_pool* pool, int item_count, tile_pool_fn fn, void* ctx) {
+    const int n = pool->thread_count;
+    if (item_count <= 0) return;
+
+    if (n == 1) {
+        for (int i = 0; i < item_count; i++) fn(ctx, i);
+        return;
+    }
+
+    // Contiguous ranges, the first item_count % n threads get one extra
+    uint32_t begin = 0;
+    for (int t = 0; t < n; t++) {
+        uint32_t len = (uint32_t)(item_count / n + (t < item_count % n));
+        atomic_store_explicit(&pool->ranges[t].items, tile_pool_pack(begin, begin + len), memory_order_relaxed);
+        begin += len;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->ctx = ctx;
+    pool->busy = n - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    tile_pool_work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->busy > 0) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
@@ -0,0 +1,59 @@
+#ifndef _TILE_POOL_H_
+#define _TILE_POOL_H_
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Persistent work-stealing thread pool for per-frame tile jobs.
+//
+// tile_pool_run() hands the items [0, count) out as one contiguous range per
+// thread, so neighbouring tiles stay on the same core. Each range lives in a
+// single atomic word: the owner pops items from the front and idle threads
+// steal single items from the back of someone else's range, so no locks are
+// taken while items remain. The calling thread works as thread 0 and the call
+// returns once every item has run. Items must not write to memory another
+// item touches; tiles and row bands each own their slice of the framebuffer.
+
+#define TILE_POOL_MAX_THREADS 64
+#define TILE_POOL_CACHE_LINE 64
+
+typedef void (*tile_pool_fn)(void* ctx, int item);
+
+typedef struct tile_pool_range {
+    // begin in the low 32 bits, end in the high 32 bits
+    _Alignas(TILE_POOL_CACHE_LINE) _Atomic uint64_t items;
+} tile_pool_range;
+
+typedef struct tile_pool_worker {
+    struct tile_pool* pool;
+    int index;
+} tile_pool_worker;
+
+typedef struct tile_pool {
+    int thread_count; // including the caller
+    pthread_t threads[TILE_POOL_MAX_THREADS];
+    tile_pool_worker workers[TILE_POOL_MAX_THREADS];
+    tile_pool_range ranges[TILE_POOL_MAX_THREADS];
+
+    // Current job, published under `lock` by bumping `generation`
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    uint64_t generation;
+    int busy;  // workers still inside the current job
+    bool stop;
+    tile_pool_fn fn;
+    void* ctx;
+} tile_pool;
+
+// thread_count <= 0 uses every online core. A pool of one thread starts no
+// workers and runs every job on the caller.
+bool tile_pool_init(tile_pool* pool, int thread_count);
+void tile_pool_free(tile_pool* pool);
+
+// Runs fn(ctx, item) for every item in [0, item_count) across the pool
+void tile_pool_run(tile_pool* pool, int item_count, tile_pool_fn fn, void* ctx);
+
+#endif /* _TILE_POOL_H_ */
@@ -0,0 +1,90 @@
+#ifndef _TRANSFORM_H_
+#define _TRANSFORM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mesh.h"
+
+// Per-frame vertex transform.
+//
+// The model rotation is folded into one 3x3 matrix per frame and every mesh
+// vertex is rotated and projected exactly once into a screen-space SoA cache.
+// Edge drawing then only indexes into the cache.
+//
+// The projection runs through one of several kernels: a scalar loop, SSE2
+// (4 vertices per step) and AVX2 (8 per step). All of them perform the same
+// IEEE operations in the same order, so their output is bit identical. AVX2
+// is picked at runtime where supported, the scalar loop otherwise: the
+// compiler vectorizes it to the baseline SSE2 width and it beats the
+// hand-written SSE2 kernel, which stays for the benchmark.
+//
+// For hidden-line rendering xform_facing() flags the triangles that face the
+// camera. The test is done against the triangle plane with the camera moved
+// into model space, which has the same sign as the winding of the projected
+// triangle but does not degenerate when a triangle shrinks below one cell.
+
+typedef struct xform_mat3 {
+    float m[3][3];  // row major, p' = m * p
+} xform_mat3;
+
+// Perspective projection: factor = scale / (z + distance), with the camera at
+// z = -distance looking down +z
+typedef struct xform_view {
+    float scale;
+    float distance;
+    int center_x;
+    int center_y;
+} xform_view;
+
+typedef enum xform_kernel {
+    XFORM_KERNEL_SCALAR,
+    XFORM_KERNEL_SSE2,
+    XFORM_KERNEL_AVX2,
+    XFORM_KERNEL_COUNT
+} xform_kernel;
+
+typedef struct xform_cache {
+    int32_t* sx;     // screen column per vertex
+    int32_t* sy;     // screen row per vertex
+    float* depth;    // scale / (z + distance) per vertex; larger is nearer and
+                     // interpolates linearly in screen space
+    uint8_t* front;  // per triangle, nonzero when facing the camera
+    uint32_t count;
+    uint32_t tri_count;
+    void* p_buffer;  // single allocation backing all planes
+} xform_cache;
+
+// Centers the view on a width x height cell viewport and scales it to fill it
+void xform_view_fit(xform_view* view, int width, int height);
+
+// Rotation about y by `angle_y` followed by a rotation about x by `angle_x`
+void xform_rotation(xform_mat3* out, float angle_y, float angle_x);
+
+bool xform_cache_init(xform_cache* cache, uint32_t count, uint32_t tri_count);
+void xform_cache_free(xform_cache* cache);
+
+// Rotates and projects all `m->vertex_count` vertices into `cache` with the
+// best kernel this CPU supports
+void xform_project(xform_cache* cache, const mesh* m, const xform_mat3* rot, const xform_view* view);
+
+// Same with an explicit kernel; unsupported kernels fall back to scalar
+void xform_project_kernel(xform_cache* cache, const mesh* m, const xform_mat3* rot, const xform_view* view, xform_kernel kernel);
+
+// Fills `cache->front` for all `m->tri_count` triangles
+void xform_facing(xform_cache* cache, const mesh* m, const xform_mat3* rot, const xform_view* view);
+
+// True if either triangle next to edge `e` faces the camera. Edges without
+// adjacent triangles are always drawn.
+static inline bool xform_edge_front(const xform_cache* cache, const mesh* m, uint32_t e) {
+    uint32_t t0 = m->edge_tris[e * 2];
+    uint32_t t1 = m->edge_tris[e * 2 + 1];
+    if (t0 == MESH_TRI_NONE) return true;
+    return cache->front[t0] || (t1 != MESH_TRI_NONE && cache->front[t1]);
+}
+
+bool xform_kernel_supported(xform_kernel kernel);
+xform_kernel xform_best_kernel(void);
+const char* xform_kernel_name(xform_kernel kernel);
+
+#endif /* _TRANSFORM_H_ */